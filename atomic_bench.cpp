@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tuple_atomic.h"
+
+// Threads updating one shared state tuple, AtomicTuple against a std::mutex around a Tuple, not
+// part of the default build:
+//   cmake --build . --target atomic_bench && ./atomic_bench
+
+namespace {
+    constexpr int operations = 2000000;
+
+    using Counters = Tuple<std::uint32_t, std::uint32_t>;
+    using Slot = Tuple<std::uint64_t, void*>;
+
+    template<typename Work>
+    double timeThreads(int threads, Work work) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> running;
+        for (int t = 0; t < threads; ++t) {
+            running.emplace_back(work);
+        }
+        for (std::thread& thread : running) {
+            thread.join();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (static_cast<double>(operations) * threads);
+    }
+
+    template<typename T>
+    struct Locked {
+        std::mutex mutex;
+        T value;
+    };
+}
+
+int main() {
+    {
+        AtomicTuple<std::uint32_t, std::uint32_t> counters;
+        AtomicTuple<std::uint64_t, void*> slot;
+        std::cout << "lock-free: Tuple<uint32_t, uint32_t> " << counters.isLockFree()
+                  << ", Tuple<uint64_t, void*> " << slot.isLockFree() << "\n";
+    }
+    // more threads than cores still contend, through preemption instead of cache-line transfers
+    std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        // a version counter in the high half: one fetch_add
+        AtomicTuple<std::uint32_t, std::uint32_t> counters;
+        const double atomicAdd = timeThreads(threads, [&] {
+            for (int i = 0; i < operations; ++i) {
+                counters.fetchAdd<1>(1, std::memory_order_relaxed);
+            }
+        });
+        Locked<Counters> lockedCounters;
+        const double mutexAdd = timeThreads(threads, [&] {
+            for (int i = 0; i < operations; ++i) {
+                std::lock_guard<std::mutex> lock(lockedCounters.mutex);
+                ++get<1>(lockedCounters.value);
+            }
+        });
+
+        // sequence number and pointer replaced together: a double-width CAS loop
+        AtomicTuple<std::uint64_t, void*> slot;
+        const double atomicCas = timeThreads(threads, [&] {
+            Slot current = slot.load(std::memory_order_relaxed);
+            for (int i = 0; i < operations; ++i) {
+                while (!slot.compareExchangeWeak(current, Slot(get<0>(current) + 1, &current))) {
+                }
+            }
+        });
+        Locked<Slot> lockedSlot;
+        const double mutexCas = timeThreads(threads, [&] {
+            Slot current;
+            for (int i = 0; i < operations; ++i) {
+                std::lock_guard<std::mutex> lock(lockedSlot.mutex);
+                lockedSlot.value = Slot(get<0>(lockedSlot.value) + 1, &current);
+            }
+        });
+
+        std::cout << threads << " threads, ns/op: fetchAdd " << atomicAdd << " vs mutex " << mutexAdd
+                  << ", 16-byte update " << atomicCas << " vs mutex " << mutexCas
+                  << " (" << get<0>(counters.load()) + get<1>(counters.load()) << ", " << get<0>(slot.load()) << ")\n";
+    }
+    return 0;
+}
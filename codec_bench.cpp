@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tuple_codec.h"
+
+// Compression ratio and decode speed of TupleEncoder on a tick-like stream, not part of the
+// default build:
+//   cmake --build . --target codec_bench && ./codec_bench
+
+namespace {
+    // timestamp ns, instrument id, sequence number, price in ticks, quantity, symbol
+    using Tick = Tuple<std::int64_t, std::uint32_t, std::uint64_t, std::int64_t, std::uint32_t, std::string>;
+
+    std::vector<Tick> makeTicks(std::size_t count) {
+        const char* symbols[] = {"AAPL", "AMZN", "GOOG", "GOOGL", "MSFT", "NVDA", "TSLA", "META"};
+        std::mt19937_64 random(7);
+        std::exponential_distribution<double> gap(1.0 / 250000.0);
+        std::vector<Tick> ticks;
+        ticks.reserve(count);
+        std::int64_t timestamp = 1700000000000000000LL;
+        std::int64_t price = 1850000;
+        std::uint32_t instrument = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            timestamp += static_cast<std::int64_t>(gap(random)) + 1;
+            // bursts on one instrument
+            if (random() % 16 == 0) {
+                instrument = static_cast<std::uint32_t>(random() % 8);
+            }
+            price += static_cast<std::int64_t>(random() % 5) - 2;
+            const std::uint32_t quantity = random() % 4 == 0 ? static_cast<std::uint32_t>(random() % 1000) : 100;
+            ticks.emplace_back(timestamp, instrument, static_cast<std::uint64_t>(i), price, quantity,
+                               std::string(symbols[instrument]));
+        }
+        return ticks;
+    }
+
+    // fixed-width fields plus a 4-byte length in front of each string
+    std::size_t plainBytes(const std::vector<Tick>& ticks) {
+        std::size_t bytes = 0;
+        for (const Tick& tick : ticks) {
+            bytes += 8 + 4 + 8 + 8 + 4 + 4 + get<5>(tick).size();
+        }
+        return bytes;
+    }
+}
+
+int main() {
+    const std::vector<Tick> ticks = makeTicks(2000000);
+    const std::size_t plain = plainBytes(ticks);
+
+    const auto encodeStart = std::chrono::steady_clock::now();
+    std::ostringstream out;
+    {
+        TupleEncoder<Tick> encoder(out);
+        for (const Tick& tick : ticks) {
+            encoder.append(tick);
+        }
+    }
+    const std::string bytes = out.str();
+    const std::chrono::duration<double> encodeTime = std::chrono::steady_clock::now() - encodeStart;
+
+    const auto decodeStart = std::chrono::steady_clock::now();
+    TupleDecoder<Tick> decoder(bytes.data(), bytes.size());
+    Tick tick;
+    std::uint64_t checksum = 0;
+    while (decoder.next(tick)) {
+        checksum += static_cast<std::uint64_t>(get<0>(tick)) + get<5>(tick).size();
+    }
+    const std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - decodeStart;
+
+    std::cout << ticks.size() << " ticks, plain " << plain << " bytes, encoded " << bytes.size() << " bytes, ratio "
+              << static_cast<double>(plain) / bytes.size() << '\n'
+              << "encode " << plain / encodeTime.count() / 1e9 << " GB/s, decode "
+              << plain / decodeTime.count() / 1e9 << " GB/s of plain rows (" << checksum << ")\n";
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+// Reads the -O2 assembly of codegen_reference.cpp and fails when a Tuple function takes more
+// instructions than its plain struct counterpart; std::tuple is printed for comparison only.
+// Instructions are the lines of a function body that are not labels or directives, its .cold
+// part included. Runs as part of the build, see CMakeLists.txt.
+
+namespace {
+    const std::string prefix = "codegen_";
+
+    struct Counts {
+        std::size_t plain = 0;
+        std::size_t tuple = 0;
+        std::size_t standard = 0;
+        bool hasPlain = false;
+        bool hasTuple = false;
+    };
+
+    bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // "codegen_less_tuple.cold:" -> "codegen_less_tuple", empty for other labels
+    std::string functionOf(const std::string& label) {
+        if (label.compare(0, prefix.size(), prefix) != 0) {
+            return std::string();
+        }
+        return label.substr(0, label.find('.'));
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "usage: codegen_check codegen_reference.s\n";
+        return 2;
+    }
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "codegen_check: cannot read " << argv[1] << "\n";
+        return 2;
+    }
+
+    std::map<std::string, std::size_t> instructions;
+    std::string current;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] != '\t' && line[0] != ' ' && line.back() == ':') {
+            const std::string label = line.substr(0, line.size() - 1);
+            // local labels like .L3 stay in the current function
+            if (label[0] != '.') {
+                current = functionOf(label);
+            }
+        } else if (line.compare(0, 6, "\t.size") == 0) {
+            current.clear();
+        } else if (!current.empty() && line[0] == '\t' && line.size() > 1 && line[1] != '.') {
+            ++instructions[current];
+        }
+    }
+
+    std::map<std::string, Counts> cases;
+    for (const auto& function : instructions) {
+        const std::string& name = function.first;
+        if (endsWith(name, "_struct")) {
+            Counts& counts = cases[name.substr(prefix.size(), name.size() - prefix.size() - 7)];
+            counts.plain = function.second;
+            counts.hasPlain = true;
+        } else if (endsWith(name, "_tuple")) {
+            Counts& counts = cases[name.substr(prefix.size(), name.size() - prefix.size() - 6)];
+            counts.tuple = function.second;
+            counts.hasTuple = true;
+        } else if (endsWith(name, "_std")) {
+            cases[name.substr(prefix.size(), name.size() - prefix.size() - 4)].standard = function.second;
+        }
+    }
+    if (cases.empty()) {
+        std::cerr << "codegen_check: no codegen_ functions in " << argv[1] << "\n";
+        return 2;
+    }
+
+    bool ok = true;
+    std::cout << std::left << std::setw(16) << "case" << std::right << std::setw(8) << "struct" << std::setw(8)
+              << "Tuple" << std::setw(12) << "std::tuple" << "\n";
+    for (const auto& entry : cases) {
+        const Counts& counts = entry.second;
+        const bool regressed = !counts.hasPlain || !counts.hasTuple || counts.tuple > counts.plain;
+        std::cout << std::left << std::setw(16) << entry.first << std::right << std::setw(8) << counts.plain
+                  << std::setw(8) << counts.tuple << std::setw(12) << counts.standard
+                  << (regressed ? "  <- Tuple costs more than the struct" : "") << "\n";
+        ok = ok && !regressed;
+    }
+    return ok ? 0 : 1;
+}
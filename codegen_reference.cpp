@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+#include "tuple.h"
+
+// Reference functions for codegen_check: every operation three times, on a plain struct, on a
+// Tuple and on a std::tuple. The names are codegen_<case>_<struct|tuple|std>; add a case by
+// adding all three. Compiled to assembly at -O2, see CMakeLists.txt.
+
+namespace {
+    struct Row {
+        int id;
+        double price;
+        long count;
+    };
+
+    struct Named {
+        int id;
+        std::string name;
+    };
+
+    using TupleRow = Tuple<int, double, long>;
+    using StdRow = std::tuple<int, double, long>;
+    using TupleNamed = Tuple<int, std::string>;
+    using StdNamed = std::tuple<int, std::string>;
+}
+
+extern "C" {
+
+int codegen_get_first_struct(const Row& row) { return row.id; }
+int codegen_get_first_tuple(const TupleRow& row) { return get<0>(row); }
+int codegen_get_first_std(const StdRow& row) { return std::get<0>(row); }
+
+long codegen_get_last_struct(const Row& row) { return row.count; }
+long codegen_get_last_tuple(const TupleRow& row) { return get<2>(row); }
+long codegen_get_last_std(const StdRow& row) { return std::get<2>(row); }
+
+double codegen_get_by_type_struct(const Row& row) { return row.price; }
+double codegen_get_by_type_tuple(const TupleRow& row) { return get<double>(row); }
+double codegen_get_by_type_std(const StdRow& row) { return std::get<double>(row); }
+
+long codegen_next_struct(const Row& row) { return row.count; }
+long codegen_next_tuple(const TupleRow& row) { return row.next().next().get(); }
+long codegen_next_std(const StdRow& row) { return std::get<2>(row); }
+
+void codegen_set_middle_struct(Row& row, double price) { row.price = price; }
+void codegen_set_middle_tuple(TupleRow& row, double price) { get<1>(row) = price; }
+void codegen_set_middle_std(StdRow& row, double price) { std::get<1>(row) = price; }
+
+double codegen_sum_struct(const Row& row) { return row.id + row.price + row.count; }
+double codegen_sum_tuple(const TupleRow& row) { return get<0>(row) + get<1>(row) + get<2>(row); }
+double codegen_sum_std(const StdRow& row) { return std::get<0>(row) + std::get<1>(row) + std::get<2>(row); }
+
+bool codegen_less_struct(const Row& x, const Row& y) {
+    return x.id < y.id || (x.id == y.id && (x.price < y.price || (x.price == y.price && x.count < y.count)));
+}
+bool codegen_less_tuple(const TupleRow& x, const TupleRow& y) { return x < y; }
+bool codegen_less_std(const StdRow& x, const StdRow& y) { return x < y; }
+
+bool codegen_equal_struct(const Row& x, const Row& y) {
+    return x.id == y.id && x.price == y.price && x.count == y.count;
+}
+bool codegen_equal_tuple(const TupleRow& x, const TupleRow& y) { return x == y; }
+bool codegen_equal_std(const StdRow& x, const StdRow& y) { return x == y; }
+
+bool codegen_less_string_struct(const Named& x, const Named& y) {
+    return x.id < y.id || (x.id == y.id && x.name < y.name);
+}
+bool codegen_less_string_tuple(const TupleNamed& x, const TupleNamed& y) { return x < y; }
+bool codegen_less_string_std(const StdNamed& x, const StdNamed& y) { return x < y; }
+
+bool codegen_equal_string_struct(const Named& x, const Named& y) {
+    return x.id == y.id && x.name == y.name;
+}
+bool codegen_equal_string_tuple(const TupleNamed& x, const TupleNamed& y) { return x == y; }
+bool codegen_equal_string_std(const StdNamed& x, const StdNamed& y) { return x == y; }
+
+}
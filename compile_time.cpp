@@ -0,0 +1,62 @@
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "tuple.h"
+
+// Compile-time stress test for long tuples, not part of the default build:
+//   cmake --build . --target compile_time
+// The Tuple class itself is a chain of TUPLE_COMPILE_TIME_SIZE nested bases, so sizes
+// above ~880 need a larger -ftemplate-depth (set for this target in CMakeLists.txt).
+
+#ifndef TUPLE_COMPILE_TIME_SIZE
+#define TUPLE_COMPILE_TIME_SIZE 1024
+#endif
+
+template<std::size_t I>
+struct Column {
+    int value;
+};
+
+template<typename T>
+struct is_even_column;
+
+template<std::size_t I>
+struct is_even_column<Column<I>> : std::integral_constant<bool, I % 2 == 0> {};
+
+template<typename Sequence>
+struct make_row;
+
+template<std::size_t... I>
+struct make_row<std::index_sequence<I...>> {
+    using type = Tuple<Column<I>...>;
+    using types = Tuple_Traits::type_list<Column<I>...>;
+};
+
+constexpr std::size_t rowSize = TUPLE_COMPILE_TIME_SIZE;
+using Row = make_row<std::make_index_sequence<rowSize>>::type;
+using RowTypes = make_row<std::make_index_sequence<rowSize>>::types;
+
+static_assert(std::is_same<Tuple_Traits::tuple_element_t<rowSize - 1, Row>, Column<rowSize - 1>>::value, "");
+static_assert(Tuple_Traits::index_of<Column<rowSize / 2>, RowTypes>::value == rowSize / 2, "");
+static_assert(std::is_same<Tuple_Traits::slice_t<rowSize / 4, 2, RowTypes>,
+                           Tuple_Traits::type_list<Column<rowSize / 4>, Column<rowSize / 4 + 1>>>::value, "");
+static_assert(Tuple_Traits::filter_t<is_even_column, RowTypes>::size() == (rowSize + 1) / 2, "");
+static_assert(Tuple_Traits::concat_t<RowTypes, RowTypes, RowTypes>::size() == 3 * rowSize, "");
+
+template<std::size_t... I>
+int sumColumns(Row& row, std::index_sequence<I...>) {
+    const int values[] = {get<I * (rowSize / 16)>(row).value...};
+    int sum = 0;
+    for (int value : values) {
+        sum += value;
+    }
+    return sum;
+}
+
+int main() {
+    Row row;
+    get<Column<rowSize / 3>>(row).value = 1;
+    auto wider = tupleCat(makeTuple(2), row);
+    return sumColumns(row, std::make_index_sequence<16>()) + get<0>(wider) - get<rowSize>(wider).value - 2;
+}
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+
+// Access and comparison throughput of a 50-column row in a -O0 build, with the accessors forced
+// inline (debug_bench) and as plain calls (debug_bench_calls, -DTUPLE_NO_FORCE_INLINE); not part
+// of the default build:
+//   cmake --build . --target debug_bench debug_bench_calls && ./debug_bench && ./debug_bench_calls
+
+namespace {
+    template<std::size_t I>
+    using Column = int;
+
+    template<typename Sequence>
+    struct make_row;
+
+    template<std::size_t... I>
+    struct make_row<std::index_sequence<I...>> {
+        using type = Tuple<Column<I>...>;
+    };
+
+    constexpr std::size_t columns = 50;
+    using Row = make_row<std::make_index_sequence<columns>>::type;
+
+    constexpr std::size_t rowCount = 20000;
+    constexpr int rounds = 20;
+
+    template<std::size_t... I>
+    long sumColumns(const Row& row, std::index_sequence<I...>) {
+        const int values[] = {get<I>(row)...};
+        long sum = 0;
+        for (const int value : values) {
+            sum += value;
+        }
+        return sum;
+    }
+
+    template<std::size_t... I>
+    void fillColumns(Row& row, int value, std::index_sequence<I...>) {
+        const int filled[] = {(get<I>(row) = I + 1 == columns ? value : 1, 0)...};
+        static_cast<void>(filled);
+    }
+
+    template<typename F>
+    void report(const char* name, std::size_t operations, F f) {
+        const auto start = std::chrono::steady_clock::now();
+        const long checksum = f();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << name << ": " << operations / ms / 1000 << " M/s (" << checksum << ")\n";
+    }
+}
+
+int main() {
+#ifdef TUPLE_NO_FORCE_INLINE
+    std::cout << "accessors as calls\n";
+#else
+    std::cout << "accessors forced inline\n";
+#endif
+    // rows differ in the last column only, so every comparison walks all 50
+    std::vector<Row> rows(rowCount);
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        fillColumns(rows[i], static_cast<int>(i % 3), std::make_index_sequence<columns>());
+    }
+
+    report("get<0..49> of a row", rowCount * rounds, [&] {
+        long sum = 0;
+        for (int round = 0; round < rounds; ++round) {
+            for (const Row& row : rows) {
+                sum += sumColumns(row, std::make_index_sequence<columns>());
+            }
+        }
+        return sum;
+    });
+    report("get<49>", rowCount * rounds * 50, [&] {
+        long sum = 0;
+        for (int round = 0; round < rounds * 50; ++round) {
+            for (const Row& row : rows) {
+                sum += get<columns - 1>(row);
+            }
+        }
+        return sum;
+    });
+    report("operator<", rowCount * rounds, [&] {
+        long count = 0;
+        for (int round = 0; round < rounds; ++round) {
+            for (std::size_t i = 1; i < rowCount; ++i) {
+                count += rows[i - 1] < rows[i];
+            }
+        }
+        return count;
+    });
+    report("operator==", rowCount * rounds, [&] {
+        long count = 0;
+        for (int round = 0; round < rounds; ++round) {
+            for (std::size_t i = 1; i < rowCount; ++i) {
+                count += rows[i - 1] == rows[i];
+            }
+        }
+        return count;
+    });
+    return 0;
+}
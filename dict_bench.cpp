@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tuple_dict.h"
+#include "tuple_hash.h"
+
+// Memory and scan, sort and hash times of 5M orders with three low-cardinality string columns:
+// rows of std::string, rows of DictString, and TupleColumns holding codes, not part of the default
+// build:
+//   cmake --build . --target dict_bench && ./dict_bench
+
+namespace {
+    // country, status, tenant, amount
+    using Plain = Tuple<std::string, std::string, std::string, std::uint32_t>;
+    using Encoded = Tuple<DictString, DictString, DictString, std::uint32_t>;
+
+    constexpr std::size_t count = 5000000;
+
+    const char* const statuses[] = {"pending", "paid", "shipped", "delivered", "cancelled", "returned"};
+
+    std::vector<Plain> makeRows() {
+        std::mt19937_64 random(1);
+        std::vector<Plain> rows;
+        rows.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t country = random() % 200;
+            const std::string tenant = std::to_string(100000 + random() % 5000);
+            rows.emplace_back(std::string(1, static_cast<char>('A' + country / 26)) + static_cast<char>('A' + country % 26),
+                              statuses[random() % 6], "tenant-" + tenant + "-eu-west", static_cast<std::uint32_t>(random() % 10000));
+        }
+        return rows;
+    }
+
+    template<typename F>
+    double millis(F f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<typename Row>
+    std::size_t rowsBytes(const std::vector<Row>& rows) {
+        std::size_t bytes = rows.capacity() * sizeof(Row);
+        for (const Row& row : rows) {
+            bytes += Tuple_Traits::heapBlockBytes(get<0>(row)) + Tuple_Traits::heapBlockBytes(get<1>(row)) +
+                     Tuple_Traits::heapBlockBytes(get<2>(row));
+        }
+        return bytes;
+    }
+
+    // f() returns a checksum, printed so the work is not optimized away
+    template<typename F>
+    void report(const char* name, F f) {
+        std::uint64_t result = 0;
+        const double ms = millis([&] {
+            result = f();
+        });
+        std::cout << "  " << name << ": " << ms << " ms (" << result << ")\n";
+    }
+}
+
+int main() {
+    const std::vector<Plain> plain = makeRows();
+    TupleColumns<Encoded> columns;
+    columns.reserve(count);
+    for (const Plain& row : plain) {
+        columns.push_back(row);
+    }
+    columns.sortDictionary<0>();
+    columns.sortDictionary<1>();
+    columns.sortDictionary<2>();
+    std::vector<Encoded> encoded;
+    encoded.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        encoded.push_back(columns[i]);
+    }
+
+    std::cout << count << " rows, " << columns.dictionary<0>().size() << " countries, "
+              << columns.dictionary<1>().size() << " statuses, " << columns.dictionary<2>().size() << " tenants\n"
+              << "memory MB: std::string rows " << rowsBytes(plain) / (1 << 20)
+              << ", DictString rows " << rowsBytes(encoded) / (1 << 20)
+              << " + dictionaries, TupleColumns " << columns.byteSize() / (1 << 20) << "\n";
+
+    std::cout << "sum of amount where status == \"shipped\"\n";
+    report("std::string rows", [&] {
+        std::uint64_t sum = 0;
+        for (const Plain& row : plain) {
+            sum += get<1>(row) == "shipped" ? get<3>(row) : 0;
+        }
+        return sum;
+    });
+    report("DictString rows ", [&] {
+        StringDictionary::Code shipped = 0;
+        columns.dictionary<1>().find("shipped", shipped);
+        const DictString key(columns.dictionary<1>(), shipped);
+        std::uint64_t sum = 0;
+        for (const Encoded& row : encoded) {
+            sum += get<1>(row) == key ? get<3>(row) : 0;
+        }
+        return sum;
+    });
+    report("TupleColumns    ", [&] {
+        StringDictionary::Code shipped = 0;
+        columns.dictionary<1>().find("shipped", shipped);
+        const std::vector<StringDictionary::Code>& status = columns.column<1>();
+        const std::vector<std::uint32_t>& amount = columns.column<3>();
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            sum += status[i] == shipped ? amount[i] : 0;
+        }
+        return sum;
+    });
+
+    std::cout << "rows with tenant in [\"tenant-101000\", \"tenant-102000\")\n";
+    report("std::string rows", [&] {
+        const std::string from = "tenant-101000", to = "tenant-102000";
+        std::uint64_t matches = 0;
+        for (const Plain& row : plain) {
+            matches += get<2>(row) >= from && get<2>(row) < to;
+        }
+        return matches;
+    });
+    report("TupleColumns    ", [&] {
+        const StringDictionary::Code from = columns.dictionary<2>().lowerBound("tenant-101000");
+        const StringDictionary::Code to = columns.dictionary<2>().lowerBound("tenant-102000");
+        std::uint64_t matches = 0;
+        for (const StringDictionary::Code tenant : columns.column<2>()) {
+            matches += tenant >= from && tenant < to;
+        }
+        return matches;
+    });
+
+    std::cout << "TupleHash of every row\n";
+    report("std::string rows", [&] {
+        std::uint64_t hashes = 0;
+        for (const Plain& row : plain) {
+            hashes += TupleHash()(row);
+        }
+        return hashes;
+    });
+    report("DictString rows ", [&] {
+        std::uint64_t hashes = 0;
+        for (const Encoded& row : encoded) {
+            hashes += TupleHash()(row);
+        }
+        return hashes;
+    });
+
+    std::cout << "std::sort by (country, status, tenant, amount)\n";
+    std::vector<Plain> sortedPlain = plain;
+    std::vector<Encoded> sortedEncoded = encoded;
+    report("std::string rows", [&] {
+        std::sort(sortedPlain.begin(), sortedPlain.end());
+        return std::uint64_t(get<3>(sortedPlain.front()));
+    });
+    report("DictString rows ", [&] {
+        std::sort(sortedEncoded.begin(), sortedEncoded.end());
+        return std::uint64_t(get<3>(sortedEncoded.front()));
+    });
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tuple_distinct.h"
+
+// Deduplicating 4M rows with many and with few duplicates: sort + std::unique and distinct in place
+// on a copy (copy not timed) against distinctStable and distinctParallel, not part of the default
+// build:
+//   cmake --build . --target distinct_bench && ./distinct_bench
+
+namespace {
+    // user id, event type, country
+    using Row = Tuple<std::uint64_t, std::uint32_t, std::string>;
+
+    constexpr std::size_t count = 4000000;
+
+    std::vector<Row> makeRows(std::uint64_t keys) {
+        std::mt19937_64 random(5);
+        std::vector<Row> rows;
+        rows.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::uint64_t key = random() % keys;
+            rows.emplace_back(key, static_cast<std::uint32_t>(key % 7), "country-" + std::to_string(key % 200));
+        }
+        return rows;
+    }
+
+    template<typename F>
+    void report(const char* name, F f) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t unique = f();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  " << name << ": " << ms << " ms (" << unique << " rows)\n";
+    }
+}
+
+int main() {
+    for (const std::uint64_t keys : {std::uint64_t(1000), std::uint64_t(1) << 40}) {
+        const std::vector<Row> rows = makeRows(keys);
+        std::cout << (keys == 1000 ? "high duplicate ratio, 1000 distinct keys\n" : "low duplicate ratio, all keys distinct\n");
+        std::vector<Row> copy = rows;
+        report("sort + std::unique", [&] {
+            std::sort(copy.begin(), copy.end());
+            return static_cast<std::size_t>(std::unique(copy.begin(), copy.end()) - copy.begin());
+        });
+        report("distinctStable", [&] {
+            return distinctStable(rows).size();
+        });
+        copy = rows;
+        report("distinct", [&] {
+            distinct(copy);
+            return copy.size();
+        });
+        report("distinctParallel, 4 threads", [&] {
+            return distinctParallel(rows, 4).size();
+        });
+    }
+    return 0;
+}
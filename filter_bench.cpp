@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "tuple_filter.h"
+
+// False-positive rate and lookup throughput of BlockedBloomFilter and CuckooFilter over 10M
+// composite keys, one lookup at a time against the batch calls, not part of the default build:
+//   cmake --build . --target filter_bench && ./filter_bench
+
+namespace {
+    // tenant, object id
+    using Key = Tuple<std::uint32_t, std::uint64_t>;
+
+    constexpr std::size_t count = 10000000;
+
+    std::vector<Key> makeKeys(std::uint64_t seed) {
+        std::mt19937_64 random(seed);
+        std::vector<Key> keys;
+        keys.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            keys.emplace_back(static_cast<std::uint32_t>(random() % 1000), random());
+        }
+        return keys;
+    }
+
+    template<typename F>
+    double millis(F f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // lookups of keys never inserted, so every hit is a false positive
+    template<typename Filter>
+    void report(const char* name, const Filter& filter, const std::vector<Key>& absent) {
+        std::size_t single = 0;
+        const double singleMs = millis([&] {
+            for (const Key& key : absent) {
+                single += filter.contains(key);
+            }
+        });
+        std::vector<char> found(absent.size());
+        const double batchMs = millis([&] {
+            filter.containsBatch(absent, found.begin());
+        });
+        std::size_t batch = 0;
+        for (const char hit : found) {
+            batch += hit;
+        }
+        std::cout << name << ": " << filter.byteSize() / (1 << 20) << " MB, false positives "
+                  << 100.0 * single / absent.size() << "%, contains " << absent.size() / singleMs / 1000
+                  << " M/s, containsBatch " << absent.size() / batchMs / 1000 << " M/s"
+                  << (batch == single ? "" : " MISMATCH") << "\n";
+    }
+}
+
+int main() {
+    const std::vector<Key> inserted = makeKeys(1);
+    const std::vector<Key> absent = makeKeys(2);
+
+    for (const double bitsPerKey : {8.0, 10.0, 12.0, 16.0, 20.0}) {
+        BlockedBloomFilter<Key> bloom(count, bitsPerKey);
+        const double insertMs = millis([&] {
+            bloom.insertBatch(inserted);
+        });
+        std::cout << "insertBatch " << count / insertMs / 1000 << " M/s, ";
+        const std::string name = "BlockedBloomFilter " + std::to_string(static_cast<int>(bitsPerKey)) + " bits/key";
+        report(name.c_str(), bloom, absent);
+    }
+
+    CuckooFilter<Key> cuckoo(count);
+    std::size_t added = 0;
+    const double insertMs = millis([&] {
+        added = cuckoo.insertBatch(inserted);
+    });
+    std::cout << "insertBatch " << count / insertMs / 1000 << " M/s (" << added << " added), ";
+    report("CuckooFilter", cuckoo, absent);
+    return 0;
+}
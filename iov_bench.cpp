@@ -0,0 +1,140 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "tuple_iov.h"
+
+// writeTuple / writeTuples against copying every batch into one buffer and writing that, into a
+// local file and through a Unix-domain socketpair drained by a reader thread, for small rows and
+// rows carrying a few kilobytes of payload, not part of the default build:
+//   cmake --build . --target iov_bench && ./iov_bench
+
+namespace {
+    // id, name, score, payload
+    using Row = Tuple<std::uint64_t, std::string, double, std::string>;
+
+    std::vector<Row> makeRows(std::size_t count, std::size_t payload) {
+        std::vector<Row> rows;
+        rows.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            rows.emplace_back(i, "user-" + std::to_string(i), i * 0.5, std::string(payload, static_cast<char>('a' + i % 26)));
+        }
+        return rows;
+    }
+
+    template<typename F>
+    double millis(F f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void append(std::string& out, const void* data, std::size_t bytes) {
+        out.append(static_cast<const char*>(data), bytes);
+    }
+
+    // the same bytes as writeTuples, copied into one buffer per batch and written with write()
+    bool copyThenWrite(int fd, const std::vector<Row>& rows) {
+        std::string buffer;
+        for (std::size_t first = 0; first < rows.size(); first += Tuple_Traits::iovBatchRows) {
+            const std::size_t last = std::min(rows.size(), first + Tuple_Traits::iovBatchRows);
+            buffer.clear();
+            const std::uint64_t count = last - first;
+            append(buffer, &count, sizeof(count));
+            for (std::size_t i = first; i < last; ++i) {
+                const std::uint64_t lengths[2] = {get<1>(rows[i]).size(), get<3>(rows[i]).size()};
+                append(buffer, lengths, sizeof(lengths));
+            }
+            for (std::size_t i = first; i < last; ++i) {
+                append(buffer, &get<0>(rows[i]), sizeof(std::uint64_t));
+                buffer += get<1>(rows[i]);
+                append(buffer, &get<2>(rows[i]), sizeof(double));
+                buffer += get<3>(rows[i]);
+            }
+            if (!Tuple_Traits::transferAll(fd, &buffer[0], buffer.size(), true)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool rowByRow(int fd, const std::vector<Row>& rows) {
+        for (const Row& row : rows) {
+            if (!writeTuple(fd, row)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename Write>
+    void toFile(const char* name, const std::vector<Row>& rows, std::size_t bytes, Write write) {
+        char path[] = "./iov_bench_XXXXXX";
+        const int fd = mkstemp(path);
+        std::remove(path);
+        // the previous runs' dirty pages would otherwise throttle this one
+        sync();
+        const double ms = millis([&] {
+            write(fd, rows);
+        });
+        std::vector<Row> read;
+        const double readMs = millis([&] {
+            lseek(fd, 0, SEEK_SET);
+            while (readTuples(fd, read)) {
+            }
+        });
+        close(fd);
+        std::cout << "  file    " << name << ": " << bytes / ms / 1000 << " MB/s";
+        if (read.size() == rows.size()) {
+            std::cout << ", readTuples " << bytes / readMs / 1000 << " MB/s";
+        }
+        std::cout << "\n";
+    }
+
+    template<typename Write>
+    void toSocket(const char* name, const std::vector<Row>& rows, std::size_t bytes, Write write) {
+        int sockets[2];
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+        std::thread reader([&] {
+            std::vector<char> sink(1 << 16);
+            while (read(sockets[1], sink.data(), sink.size()) > 0) {
+            }
+        });
+        const double ms = millis([&] {
+            write(sockets[0], rows);
+            close(sockets[0]);
+            reader.join();
+        });
+        close(sockets[1]);
+        std::cout << "  socket  " << name << ": " << bytes / ms / 1000 << " MB/s\n";
+    }
+}
+
+int main() {
+    for (const std::size_t payload : {std::size_t(0), std::size_t(64), std::size_t(4096), std::size_t(65536)}) {
+        const std::size_t count = payload < 4096 ? 2000000 : 400000000 / payload;
+        const std::vector<Row> rows = makeRows(count, payload);
+        std::size_t bytes = 0;
+        for (const Row& row : rows) {
+            bytes += 2 * sizeof(std::uint64_t) + sizeof(std::uint64_t) + get<1>(row).size() + sizeof(double) + get<3>(row).size();
+        }
+        std::cout << count << " rows, " << payload << " byte payload, " << bytes / (1 << 20) << " MB\n";
+        toFile("writeTuples  ", rows, bytes, [](int fd, const std::vector<Row>& r) { writeTuples(fd, r); });
+        toFile("copyThenWrite", rows, bytes, copyThenWrite);
+        toSocket("writeTuples  ", rows, bytes, [](int fd, const std::vector<Row>& r) { writeTuples(fd, r); });
+        toSocket("copyThenWrite", rows, bytes, copyThenWrite);
+        if (payload >= 4096) {
+            toSocket("writeTuple   ", rows, bytes, rowByRow);
+        }
+    }
+    return 0;
+}
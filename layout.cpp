@@ -0,0 +1,17 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tuple_layout.h"
+
+// prints the layout tables of the row types below, add your own hot rows here
+
+int main() {
+    printTupleLayout<Tuple<char, int, char>>(std::cout);
+    printTupleLayout<Tuple<std::uint64_t, std::uint32_t, std::uint16_t, std::uint8_t>>(std::cout);
+    printTupleLayout<Tuple<std::uint8_t, std::uint64_t>>(std::cout);
+    printTupleLayout<Tuple<int, double, std::string>>(std::cout);
+    printTupleLayout<Tuple<std::int64_t, std::vector<int>, const char*>>(std::cout);
+    return 0;
+}
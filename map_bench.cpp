@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "tuple_map.h"
+
+// Aggregator workload from 1 to 64 threads, 90% reads or 90% writes over 100k keys: one
+// std::unordered_map behind a mutex against ConcurrentTupleMap, not part of the default build:
+//   cmake --build . --target map_bench && ./map_bench
+
+namespace {
+    // tenant, metric
+    using Key = Tuple<std::uint32_t, std::uint32_t>;
+
+    constexpr std::size_t keyCount = 100000;
+    constexpr std::size_t operations = 4000000;
+
+    class LockedMap {
+    public:
+        void upsert(const Key& key) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_map[key];
+        }
+
+        bool find(const Key& key, std::uint64_t& value) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            const auto found = _map.find(key);
+            if (found == _map.end()) {
+                return false;
+            }
+            value = found->second;
+            return true;
+        }
+
+    private:
+        std::mutex _mutex;
+        std::unordered_map<Key, std::uint64_t, TupleHash> _map;
+    };
+
+    class ShardedMap {
+    public:
+        void upsert(const Key& key) {
+            _map.upsert(key, [](std::uint64_t& value) { ++value; });
+        }
+
+        bool find(const Key& key, std::uint64_t& value) {
+            return _map.find(key, value);
+        }
+
+    private:
+        ConcurrentTupleMap<Key, std::uint64_t> _map;
+    };
+
+    // million operations per second over all threads
+    template<typename Map>
+    double run(unsigned threads, unsigned writePercent) {
+        Map map;
+        for (std::uint32_t i = 0; i < keyCount; ++i) {
+            map.upsert(Key(i % 1000, i / 1000));
+        }
+        std::vector<std::thread> workers;
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&map, t, threads, writePercent] {
+                std::mt19937 random(t);
+                std::uint64_t value = 0;
+                for (std::size_t i = 0; i < operations / threads; ++i) {
+                    const std::uint32_t k = random() % keyCount;
+                    const Key key(k % 1000, k / 1000);
+                    if (random() % 100 < writePercent) {
+                        map.upsert(key);
+                    } else {
+                        map.find(key, value);
+                    }
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        return operations / std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main() {
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    for (const unsigned writePercent : {10u, 90u}) {
+        std::cout << writePercent << "% writes, M ops/s (locked unordered_map / ConcurrentTupleMap)\n";
+        for (unsigned threads = 1; threads <= 64; threads *= 2) {
+            std::cout << "  " << threads << " threads: " << run<LockedMap>(threads, writePercent) << " / "
+                      << run<ShardedMap>(threads, writePercent) << "\n";
+        }
+    }
+    return 0;
+}
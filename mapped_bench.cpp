@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "tuple_mapped.h"
+
+// Startup of a sorted lookup table: deserializing every row into a std::vector versus opening
+// the mapping and answering the first lookups, not part of the default build:
+//   cmake --build . --target mapped_bench && ./mapped_bench
+
+namespace {
+    using Row = Tuple<std::uint64_t, std::uint32_t, double, std::string>;
+    using Table = MappedTupleTable<std::uint64_t, std::uint32_t, double, std::string>;
+
+    const char* const path = "mapped_bench.tbl";
+    constexpr std::size_t rowCount = 5000000;
+    constexpr std::size_t lookups = 1000;
+
+    // asks the kernel to drop the file from the page cache so that both runs start from disk
+    void evict() {
+        const int fd = ::open(path, O_RDONLY);
+        if (fd >= 0) {
+            ::fdatasync(fd);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main() {
+    {
+        std::vector<Row> rows;
+        rows.reserve(rowCount);
+        std::mt19937_64 random(3);
+        std::uint64_t key = 0;
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            key += 1 + random() % 16;
+            rows.emplace_back(key, static_cast<std::uint32_t>(random()), static_cast<double>(i) * 0.01,
+                              "customer-" + std::to_string(random() % 100000));
+        }
+        if (!writeMappedTable(path, rows)) {
+            std::cerr << "cannot write " << path << '\n';
+            return 1;
+        }
+    }
+
+    std::mt19937_64 random(5);
+    std::vector<std::uint64_t> keys(lookups);
+    for (std::uint64_t& key : keys) {
+        key = random() % (rowCount * 8);
+    }
+
+    std::uint64_t checksum = 0;
+    // a restart usually finds the file in the page cache, a fresh machine does not
+    for (bool cold : {false, true}) {
+        const char* cache = cold ? "evicted page cache" : "warm page cache";
+
+        if (cold) {
+            evict();
+        }
+        auto start = std::chrono::steady_clock::now();
+        {
+            Table table(path);
+            std::vector<Row> rows;
+            rows.reserve(table.size());
+            for (auto row : table) {
+                rows.push_back(row.load());
+            }
+            for (std::uint64_t key : keys) {
+                const auto found = std::lower_bound(rows.begin(), rows.end(), key, [](const Row& row, std::uint64_t k) {
+                    return get<0>(row) < k;
+                });
+                checksum += found != rows.end() ? get<1>(*found) : 0;
+            }
+        }
+        std::cout << cache << ", deserialize " << rowCount << " rows + " << lookups << " lookups: "
+                  << elapsedMs(start) << " ms\n";
+
+        if (cold) {
+            evict();
+        }
+        start = std::chrono::steady_clock::now();
+        {
+            Table table(path);
+            for (std::uint64_t key : keys) {
+                const std::size_t found = table.lowerBound(makeTuple(key));
+                checksum -= found != table.size() ? table.get<1>(found) : 0;
+            }
+        }
+        std::cout << cache << ", mmap open + " << lookups << " lookups: " << elapsedMs(start) << " ms\n";
+    }
+    std::cout << "checksum " << checksum << '\n';
+
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "tuple_order.h"
+
+// std::sort by (price desc, timestamp asc, id asc) with orderBy against the hand-written lambda it
+// should compile to, not part of the default build:
+//   cmake --build . --target order_bench && ./order_bench
+
+namespace {
+    // timestamp, id, price
+    using Row = Tuple<std::int64_t, std::uint32_t, double>;
+
+    constexpr std::size_t rowCount = 2000000;
+    constexpr int repeats = 5;
+
+    std::vector<Row> makeRows() {
+        std::mt19937_64 random(6);
+        std::vector<Row> rows;
+        rows.reserve(rowCount);
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            rows.emplace_back(static_cast<std::int64_t>(random() % 1000000), static_cast<std::uint32_t>(i),
+                              static_cast<double>(random() % 500) * 0.25);
+        }
+        return rows;
+    }
+
+    // best of a few runs, each on a fresh copy
+    template<typename Less>
+    double sortMs(const std::vector<Row>& input, Less less, std::vector<Row>& output) {
+        double best = 0;
+        for (int r = 0; r < repeats; ++r) {
+            output = input;
+            const auto start = std::chrono::steady_clock::now();
+            std::sort(output.begin(), output.end(), less);
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = r == 0 || ms < best ? ms : best;
+        }
+        return best;
+    }
+}
+
+int main() {
+    const std::vector<Row> rows = makeRows();
+    std::vector<Row> compiled, handWritten;
+
+    const double orderByMs = sortMs(rows, orderBy<Desc<2>, Asc<0>, Asc<1>>, compiled);
+    const double lambdaMs = sortMs(rows, [](const Row& left, const Row& right) {
+        if (get<2>(left) != get<2>(right)) {
+            return get<2>(left) > get<2>(right);
+        }
+        if (get<0>(left) != get<0>(right)) {
+            return get<0>(left) < get<0>(right);
+        }
+        return get<1>(left) < get<1>(right);
+    }, handWritten);
+
+    std::cout << rowCount << " rows, best of " << repeats << ": orderBy " << orderByMs << " ms, hand-written "
+              << lambdaMs << " ms" << (compiled == handWritten ? "" : ", RESULTS DIFFER") << '\n';
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tuple_queue.h"
+
+// Event scheduler workload, std::priority_queue against TuplePriorityQueue, not part of the
+// default build:
+//   cmake --build . --target queue_bench && ./queue_bench
+
+namespace {
+    // due time, sequence number, task name
+    using Event = Tuple<std::uint64_t, std::uint32_t, std::string>;
+    using Later = std::greater<Event>;
+
+    constexpr std::size_t queued = 1000000;
+    constexpr std::size_t operations = 3000000;
+
+    std::vector<Event> makeEvents(std::size_t count) {
+        std::mt19937_64 random(9);
+        std::vector<Event> events;
+        events.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            events.emplace_back(random() % 1000000, static_cast<std::uint32_t>(i),
+                                "task-with-a-long-name-" + std::to_string(i % 1000));
+        }
+        return events;
+    }
+
+    // keeps `queued` events pending: every step pops the earliest and reschedules it later
+    template<typename Queue, typename Pop>
+    double run(Queue& queue, const std::vector<Event>& events, Pop pop, std::uint64_t& checksum) {
+        for (std::size_t i = 0; i < queued; ++i) {
+            queue.push(events[i]);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < operations; ++i) {
+            Event event = pop(queue);
+            checksum += get<0>(event);
+            get<0>(event) += 1 + get<0>(events[i % events.size()]) % 5000;
+            queue.push(std::move(event));
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<typename Queue>
+    void report(const char* name, const std::vector<Event>& events) {
+        Queue queue;
+        std::uint64_t checksum = 0;
+        const double ms = run(queue, events, [](Queue& q) {
+            return q.takeTop();
+        }, checksum);
+        std::cout << name << ": " << ms << " ms (" << checksum << ")\n";
+    }
+}
+
+int main() {
+    const std::vector<Event> events = makeEvents(queued);
+
+    {
+        std::priority_queue<Event, std::vector<Event>, Later> queue;
+        std::uint64_t checksum = 0;
+        const double ms = run(queue, events, [](std::priority_queue<Event, std::vector<Event>, Later>& q) {
+            Event event = q.top();
+            q.pop();
+            return event;
+        }, checksum);
+        std::cout << "std::priority_queue: " << ms << " ms (" << checksum << ")\n";
+    }
+    report<TuplePriorityQueue<Event, Later, 2, false>>("TuplePriorityQueue binary, no key cache", events);
+    report<TuplePriorityQueue<Event, Later, 4, false>>("TuplePriorityQueue 4-ary, no key cache", events);
+    report<TuplePriorityQueue<Event, Later, 2>>("TuplePriorityQueue binary, cached key", events);
+    report<TuplePriorityQueue<Event, Later>>("TuplePriorityQueue 4-ary, cached key", events);
+    report<TuplePriorityQueue<Event, Later, 8>>("TuplePriorityQueue 8-ary, cached key", events);
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "tuple_search.h"
+
+// Random point lookups into sorted tables of 1M rows up to the given maximum (default 256M rows,
+// 2 GB), std::lower_bound per query against lowerBoundBatch, not part of the default build:
+//   cmake --build . --target search_bench && ./search_bench [max rows]
+
+namespace {
+    // key, version
+    using Row = Tuple<std::uint32_t, std::uint32_t>;
+
+    constexpr std::size_t lookups = 4000000;
+
+    template<typename F>
+    double millis(F f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    const std::size_t maxRows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : std::size_t(1) << 28;
+    std::mt19937_64 random(3);
+    for (std::size_t size = std::size_t(1) << 20; size <= maxRows; size *= 4) {
+        // two versions per key, every third key missing
+        std::vector<Row> rows(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            rows[i] = Row(static_cast<std::uint32_t>(i / 2 * 3), static_cast<std::uint32_t>(i % 2));
+        }
+        std::vector<Row> queries(lookups);
+        for (Row& query : queries) {
+            query = Row(static_cast<std::uint32_t>(random() % (size / 2 * 3)), 1);
+        }
+
+        std::vector<std::size_t> expected(lookups);
+        const double scalar = millis([&] {
+            for (std::size_t i = 0; i < lookups; ++i) {
+                expected[i] = static_cast<std::size_t>(std::lower_bound(rows.begin(), rows.end(), queries[i],
+                        [](const Row& x, const Row& y) { return Tuple_Traits::lower(x, y); }) - rows.begin());
+            }
+        });
+        std::vector<std::size_t> positions(lookups);
+        const double batched = millis([&] {
+            lowerBoundBatch(rows, queries, positions.begin());
+        });
+
+        std::cout << size << " rows: std::lower_bound " << lookups / scalar / 1000 << " M lookups/s, lowerBoundBatch "
+                  << lookups / batched / 1000 << " M lookups/s" << (positions == expected ? "" : " MISMATCH") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "tuple_seqlock.h"
+
+// Readers taking copies of a 96-byte statistics row while one writer keeps updating it, SeqlockTuple
+// against std::mutex and std::shared_timed_mutex, from one reader up to all cores, not part of the
+// default build:
+//   cmake --build . --target seqlock_bench && ./seqlock_bench
+
+namespace {
+    using Row = Tuple<std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t,
+                      std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t>;
+    using Seqlocked = SeqlockTuple<std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t,
+                                   std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t,
+                                   std::uint64_t, std::uint64_t>;
+
+    constexpr auto duration = std::chrono::milliseconds(300);
+
+    Row makeRow(std::uint64_t i) {
+        return Row(i, i, i, i, i, i, i, i, i, i, i, i);
+    }
+
+    // millions of reads per second summed over all readers, with a writer updating every microsecond
+    template<typename Read, typename Write>
+    double readRate(int readers, Read read, Write write) {
+        std::atomic<bool> done(false);
+        std::atomic<std::uint64_t> reads(0);
+        std::vector<std::thread> threads;
+        threads.emplace_back([&] {
+            for (std::uint64_t i = 1; !done.load(std::memory_order_relaxed); ++i) {
+                write(makeRow(i));
+                const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(1);
+                while (std::chrono::steady_clock::now() < until) {
+                }
+            }
+        });
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&] {
+                std::uint64_t count = 0;
+                std::uint64_t checksum = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    checksum += get<11>(read());
+                    ++count;
+                }
+                reads += count + (checksum == 1);
+            });
+        }
+        std::this_thread::sleep_for(duration);
+        done = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        return static_cast<double>(reads.load()) / std::chrono::duration<double, std::micro>(duration).count();
+    }
+}
+
+int main() {
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    std::vector<int> readerCounts;
+    for (int readers = 1; readers < cores; readers *= 2) {
+        readerCounts.push_back(readers);
+    }
+    readerCounts.push_back(cores > 0 ? cores : 1);
+
+    for (int readers : readerCounts) {
+        Seqlocked seqlocked;
+        const double seqlock = readRate(readers, [&] { return seqlocked.read(); },
+                                        [&](const Row& row) { seqlocked.write(row); });
+
+        std::mutex mutex;
+        Row locked;
+        const double exclusive = readRate(readers, [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            return locked;
+        }, [&](const Row& row) {
+            std::lock_guard<std::mutex> lock(mutex);
+            locked = row;
+        });
+
+        std::shared_timed_mutex sharedMutex;
+        Row shared;
+        const double readerWriter = readRate(readers, [&] {
+            std::shared_lock<std::shared_timed_mutex> lock(sharedMutex);
+            return shared;
+        }, [&](const Row& row) {
+            std::lock_guard<std::shared_timed_mutex> lock(sharedMutex);
+            shared = row;
+        });
+
+        std::cout << readers << " readers, M reads/s: seqlock " << seqlock << ", mutex " << exclusive
+                  << ", shared_timed_mutex " << readerWriter << '\n';
+    }
+    return 0;
+}
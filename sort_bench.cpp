@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "tuple.h"
+
+// Sorts rows with large elements, not part of the default build:
+//   cmake --build . --target sort_bench && ./sort_bench
+
+namespace {
+    // a heap buffer without move operations: moving it copies 4 KiB, its swap exchanges pointers
+    class Buffer {
+    public:
+        explicit Buffer(int fill = 0) : _data(new std::array<int, 1024>()) {
+            _data->fill(fill);
+        }
+
+        Buffer(const Buffer& other) : _data(new std::array<int, 1024>(*other._data)) {}
+
+        Buffer& operator=(const Buffer& other) {
+            *_data = *other._data;
+            return *this;
+        }
+
+        int front() const {
+            return _data->front();
+        }
+
+        friend void swap(Buffer& first, Buffer& second) noexcept {
+            first._data.swap(second._data);
+        }
+
+    private:
+        std::unique_ptr<std::array<int, 1024>> _data;
+    };
+
+    template<typename Row, typename Make>
+    void benchSort(const char* name, std::size_t count, Make make) {
+        std::mt19937 random(42);
+        std::vector<Row> rows;
+        rows.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            rows.push_back(make(static_cast<int>(random() % count)));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::sort(rows.begin(), rows.end(), [](const Row& first, const Row& second) {
+            return get<0>(first) < get<0>(second);
+        });
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        std::cout << name << ": " << count << " rows sorted in " << elapsed.count() << " ms\n";
+    }
+
+    template<typename Row, typename Make>
+    void benchSwap(const char* name, std::size_t count, Make make) {
+        std::vector<Row> rows;
+        for (std::size_t i = 0; i < 2; ++i) {
+            rows.push_back(make(static_cast<int>(i)));
+        }
+
+        using std::swap;
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < count; ++i) {
+            swap(rows[0], rows[1]);
+        }
+        const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        std::cout << name << ": " << count << " swaps in " << elapsed.count() << " ms (" << get<0>(rows[0]) << ")\n";
+    }
+}
+
+int main() {
+    using BufferRow = Tuple<int, Buffer>;
+    const auto makeBufferRow = [](int key) { return BufferRow(key, Buffer(key)); };
+    benchSort<BufferRow>("Tuple<int, Buffer>", 20000, makeBufferRow);
+    benchSwap<BufferRow>("Tuple<int, Buffer>", 1000000, makeBufferRow);
+
+    using WideRow = Tuple<std::uint64_t, std::array<std::uint64_t, 31>>;
+    const auto makeWideRow = [](int key) {
+        std::array<std::uint64_t, 31> payload;
+        payload.fill(static_cast<std::uint64_t>(key));
+        return WideRow(static_cast<std::uint64_t>(key), payload);
+    };
+    benchSort<WideRow>("Tuple<uint64_t, array<uint64_t, 31>>", 200000, makeWideRow);
+    benchSwap<WideRow>("Tuple<uint64_t, array<uint64_t, 31>>", 10000000, makeWideRow);
+    return 0;
+}
@@ -5,8 +5,45 @@
 #include <functional>
 #include <algorithm>
 #include <tuple>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <cctype>
+#include <queue>
+#include <type_traits>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <cstdio>
+#include <random>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <string>
+#include <thread>
 
 #include "tuple.h"
+#include "tuple_atomic.h"
+#include "tuple_codec.h"
+#include "tuple_dict.h"
+#include "tuple_distinct.h"
+#include "tuple_filter.h"
+#include "tuple_iov.h"
+#include "tuple_join.h"
+#include "tuple_layout.h"
+#include "tuple_map.h"
+#include "tuple_mapped.h"
+#include "tuple_order.h"
+#include "tuple_memo.h"
+#include "tuple_queue.h"
+#include "tuple_seqlock.h"
+#include "tuple_search.h"
+#include "tuple_sort.h"
+#include "tuple_topk.h"
+#include "tuple_visit.h"
+#include "tuple_zip.h"
 
 
 void test_tuple() {
@@ -116,8 +153,1368 @@ void test_tuple() {
 
 }
 
+void test_hash_join() {
+    std::vector<Tuple<int, std::string>> users;
+    users.emplace_back(1, std::string("alice"));
+    users.emplace_back(2, std::string("bob"));
+    users.emplace_back(3, std::string("carol"));
+
+    std::vector<Tuple<long, int, double>> orders;
+    for (int i = 0; i < 100; ++i) {
+        orders.emplace_back(static_cast<long>(i), i % 4, i * 0.5);
+    }
+
+    {
+        auto joined = hashJoin<Columns<0>, Columns<1>>(users, orders);
+        assert(joined.size() == 75);
+        std::sort(joined.begin(), joined.end());
+        assert(get<0>(joined[0]) == 1);
+        assert(get<1>(joined[0]) == std::string("alice"));
+        assert(get<2>(joined[0]) == 1);
+        assert(get<3>(joined[0]) == 1);
+        for (const auto& row : joined) {
+            assert(get<0>(row) == get<3>(row));
+        }
+        assert(get<1>(users[0]) == std::string("alice"));
+    }
+
+    {
+        auto joined = hashJoin<Columns<1>, Columns<0>>(orders, users);
+        assert(joined.size() == 75);
+        for (const auto& row : joined) {
+            assert(get<1>(row) == get<3>(row));
+        }
+    }
+
+    {
+        std::vector<Tuple<int, int>> left, right;
+        for (int i = 0; i < 20000; ++i) {
+            left.emplace_back(i % 5000, i);
+            right.emplace_back(i % 7000, i / 3);
+        }
+        auto expected = hashJoin<Columns<0, 1>, Columns<0, 1>>(left, right);
+        auto radix = radixHashJoin<Columns<0, 1>, Columns<0, 1>>(left, right);
+        auto fixed = radixHashJoin<Columns<0, 1>, Columns<0, 1>>(left, right, 4);
+        std::sort(expected.begin(), expected.end());
+        std::sort(radix.begin(), radix.end());
+        std::sort(fixed.begin(), fixed.end());
+        assert(!expected.empty());
+        assert(expected == radix);
+        assert(expected == fixed);
+    }
+}
+
+void test_layout() {
+    using Row = Tuple<char, int, char>;
+    static_assert(tupleOffsetOf<2, Row>() == 0, "last element is stored first");
+    static_assert(tupleOffsetOf<1, Row>() == 4, "");
+    static_assert(tupleOffsetOf<0, Row>() == 8, "");
+    static_assert(tuplePayloadBytes<Row>() == 6, "");
+    static_assert(tuplePaddingBytes<Row>() == sizeof(Row) - 6, "");
+    static_assert(!tupleIsPacked<Row>(), "");
+    static_assert(!tupleOffsetsAscending<Row>(), "");
+
+    using Packed = Tuple<std::uint32_t, std::uint32_t>;
+    static_assert(tupleIsPacked<Packed>(), "");
+    static_assert(!tupleIsStandardLayout<Packed>(), "");
+    static_assert(tupleIsStandardLayout<Tuple<int>>(), "");
+    static_assert(std::is_trivially_copyable<Packed>::value, "");
+
+    Packed packed(1, 2);
+    const char* bytes = reinterpret_cast<const char*>(&packed);
+    assert(*reinterpret_cast<const std::uint32_t*>(bytes + tupleOffsetOf<0, Packed>()) == 1);
+    assert(*reinterpret_cast<const std::uint32_t*>(bytes + tupleOffsetOf<1, Packed>()) == 2);
+}
+
+void test_type_list() {
+    using Tuple_Traits::type_list;
+    using List = type_list<char, int, long, int>;
+    static_assert(std::is_same<Tuple_Traits::type_at_t<2, List>, long>::value, "");
+    static_assert(Tuple_Traits::index_of<int, List>::value == 1, "first match wins");
+    static_assert(Tuple_Traits::index_of<double, List>::value == List::size(), "");
+    static_assert(std::is_same<Tuple_Traits::slice_t<1, 2, List>, type_list<int, long>>::value, "");
+    static_assert(std::is_same<Tuple_Traits::drop_t<4, List>, type_list<>>::value, "");
+    static_assert(std::is_same<Tuple_Traits::concat_t<type_list<char>, type_list<>, type_list<int, long>>,
+                               type_list<char, int, long>>::value, "");
+    static_assert(std::is_same<Tuple_Traits::filter_t<std::is_integral, type_list<int, float, long>>,
+                               type_list<int, long>>::value, "");
+    static_assert(std::is_same<Tuple_Traits::tuple_tail_t<2, Tuple<char, int, long, int>>, Tuple<long, int>>::value, "");
+
+    const Tuple<int, std::string> tuple(1, std::string("one"));
+    static_assert(std::is_same<decltype(get<1>(tuple)), const std::string&>::value, "");
+    static_assert(std::is_same<decltype(get<int>(std::move(tuple))), const int&&>::value, "");
+    auto merged = tupleCat(makeTuple('a'), tuple);
+    assert(get<2>(merged) == "one");
+
+    // a class derived from a Tuple is read like the Tuple itself
+    struct Point : Tuple<int, double> {
+        using Tuple<int, double>::Tuple;
+    };
+    Point point(3, 0.5);
+    get<0>(point) = 4;
+    static_assert(std::is_same<decltype(get<1>(std::move(point))), double&&>::value, "");
+    assert(get<0>(point) == 4 && get<double>(static_cast<const Point&>(point)) == 0.5);
+    static_assert(!Tuple_Traits::is_tuple_based<int>::value && Tuple_Traits::is_tuple_based<Point&>::value, "");
+}
+
+namespace swap_test {
+    struct Buffer {
+        std::vector<int> data;
+        int swaps = 0;
+    };
+
+    void swap(Buffer& first, Buffer& second) noexcept {
+        first.data.swap(second.data);
+        ++first.swaps;
+        ++second.swaps;
+    }
+
+    struct Throwing {
+        Throwing() = default;
+        Throwing(Throwing&&) noexcept(false) {}
+        Throwing& operator=(Throwing&&) noexcept(false) { return *this; }
+    };
+}
+
+void test_swap() {
+    using swap_test::Buffer;
+    Tuple<int, Buffer> first(1, Buffer{std::vector<int>(3, 1)});
+    Tuple<int, Buffer> second(2, Buffer{std::vector<int>(5, 2)});
+    static_assert(noexcept(swap(first, second)), "");
+    static_assert(!noexcept(std::declval<Tuple<int, swap_test::Throwing>&>().swap(
+            std::declval<Tuple<int, swap_test::Throwing>&>())), "");
+
+    swap(first, second);
+    assert(get<0>(first) == 2 && get<1>(first).data.size() == 5);
+    assert(get<0>(second) == 1 && get<1>(second).data.size() == 3);
+    assert(get<1>(first).swaps == 1);
+
+    std::vector<Tuple<int, Buffer>> rows;
+    for (int i = 0; i < 20; ++i) {
+        rows.emplace_back((i * 7) % 20, Buffer{std::vector<int>(1, (i * 7) % 20)});
+    }
+    std::sort(rows.begin(), rows.end(), [](const Tuple<int, Buffer>& a, const Tuple<int, Buffer>& b) {
+        return get<0>(a) < get<0>(b);
+    });
+    for (int i = 0; i < 20; ++i) {
+        assert(get<0>(rows[i]) == i && get<1>(rows[i]).data[0] == i);
+    }
+
+    // packed and trivially copyable, swapped as one block
+    using Packed = Tuple<std::uint32_t, std::uint16_t, std::uint16_t>;
+    static_assert(Tuple_Traits::isBlockSwappable<Packed, std::uint32_t, std::uint16_t, std::uint16_t>(), "");
+    static_assert(!Tuple_Traits::isBlockSwappable<Tuple<char, int>, char, int>(), "padded");
+    Packed left(1, 2, 3);
+    Packed right(4, 5, 6);
+    left.swap(right);
+    assert(get<0>(left) == 4 && get<1>(left) == 5 && get<2>(left) == 6);
+    assert(get<0>(right) == 1 && get<1>(right) == 2 && get<2>(right) == 3);
+    left.swap(left);
+    assert(get<0>(left) == 4);
+
+    // the padded outer level swaps elementwise and the packed tail as a block
+    Tuple<char, std::uint32_t, std::uint32_t> outer(1, 2, 3);
+    Tuple<char, std::uint32_t, std::uint32_t> other(4, 5, 6);
+    swap(outer, other);
+    assert(get<0>(outer) == 4 && get<1>(outer) == 5 && get<2>(outer) == 6);
+    assert(get<0>(other) == 1 && get<1>(other) == 2 && get<2>(other) == 3);
+}
+
+void test_codec() {
+    using Row = Tuple<std::int64_t, std::uint32_t, std::string, double, bool>;
+    std::vector<Row> rows;
+    for (int i = 0; i < 1000; ++i) {
+        rows.emplace_back(std::int64_t(1000000) + i * 10 - (i % 7 == 0 ? 3 : 0), std::uint32_t(i / 50),
+                          std::string(i % 300 < 150 ? "AAPL" : "AAPL.O") + std::to_string(i / 100),
+                          i * 0.5, i % 2 == 0);
+    }
+    rows.emplace_back(std::numeric_limits<std::int64_t>::min(), 0u, std::string(), -1.0, true);
+    rows.emplace_back(std::numeric_limits<std::int64_t>::max(), ~0u, std::string(300, 'x'), 0.0, false);
+
+    std::ostringstream out;
+    {
+        TupleEncoder<Row> encoder(out, 64);
+        for (const Row& row : rows) {
+            encoder.append(row);
+        }
+    }
+    const std::string bytes = out.str();
+
+    TupleDecoder<Row> decoder(bytes.data(), bytes.size());
+    assert(decoder.valid());
+    assert(decoder.size() == rows.size());
+    assert(decoder.blockCount() == (rows.size() + 63) / 64);
+    Row row;
+    bool read = true;
+    for (const Row& expected : rows) {
+        read = decoder.next(row);
+        assert(read && row == expected);
+    }
+    read = decoder.next(row);
+    assert(!read);
+
+    bool sought = decoder.seek(700);
+    read = decoder.next(row);
+    assert(sought && read && row == rows[700]);
+    sought = decoder.seek(130);
+    read = decoder.next(row);
+    assert(sought && read && row == rows[130]);
+    read = decoder.next(row);
+    assert(read && row == rows[131]);
+    sought = decoder.seek(129);
+    read = decoder.next(row);
+    assert(sought && read && row == rows[129]);
+    sought = decoder.seek(rows.size());
+    assert(!sought);
+
+    std::string damaged = bytes;
+    damaged[damaged.size() - 1] = 'X';
+    assert(!TupleDecoder<Row>(damaged.data(), damaged.size()).valid());
+    // a damaged block is refused, the others stay readable
+    damaged = bytes;
+    damaged[0] = 5;
+    TupleDecoder<Row> partial(damaged.data(), damaged.size());
+    assert(partial.valid());
+    read = partial.next(row);
+    assert(!read);
+    sought = partial.seek(64);
+    read = partial.next(row);
+    assert(sought && read && row == rows[64]);
+
+    std::ostringstream empty;
+    TupleEncoder<Tuple<int>>(empty).finish();
+    const std::string emptyBytes = empty.str();
+    TupleDecoder<Tuple<int>> emptyDecoder(emptyBytes.data(), emptyBytes.size());
+    assert(emptyDecoder.valid() && emptyDecoder.size() == 0);
+    Tuple<int> value;
+    read = emptyDecoder.next(value);
+    assert(!read);
+}
+
+void test_mapped() {
+    using Row = Tuple<std::uint32_t, std::string, double>;
+    std::vector<Row> rows;
+    for (std::uint32_t i = 0; i < 500; ++i) {
+        rows.emplace_back(i / 2 * 3, std::string(i % 5, char('a' + i % 26)), i * 0.25);
+    }
+    char temp[] = "/tmp/tuple_mapped_XXXXXX";
+    const int fd = mkstemp(temp);
+    assert(fd >= 0);
+    close(fd);
+    const std::string path = temp;
+    const bool written = writeMappedTable(path, rows);
+    assert(written);
+
+    {
+        MappedTupleTable<std::uint32_t, std::string, double> table(path);
+        assert(table.valid());
+        assert(table.size() == rows.size());
+        assert(table.get<0>(10) == 15);
+        assert(table.get<1>(7) == get<1>(rows[7]));
+        assert(table[499].get<2>() == get<2>(rows[499]));
+
+        std::size_t index = 0;
+        for (auto row : table) {
+            assert(row.load() == rows[index]);
+            ++index;
+        }
+        assert(index == rows.size());
+
+        assert(table.lowerBound(makeTuple(std::uint32_t(300))) == 200);
+        assert(table.upperBound(makeTuple(std::uint32_t(300))) == 202);
+        assert(table.lowerBound(makeTuple(std::uint32_t(301))) == 202);
+        assert(table.lowerBound(makeTuple(std::uint32_t(1000))) == rows.size());
+        assert(table.lowerBound(makeTuple(std::uint32_t(300), get<1>(rows[201]))) == 201);
+        assert(std::is_sorted(table.begin(), table.end(), [](decltype(*table.begin()) a, decltype(*table.begin()) b) {
+            return a.get<0>() < b.get<0>();
+        }));
+
+        // the whole random-access iterator set
+        auto it = table.begin();
+        assert((it++)->get<0>() == 0 && it->get<0>() == 0 && (++it)->get<0>() == 3);
+        assert((it--) - table.begin() == 2 && (--it) == table.begin());
+        it += 10;
+        it -= 4;
+        assert(it - table.begin() == 6 && (it - 6) == table.begin() && (6 + table.begin()) == it);
+        assert(it > table.begin() && it >= it && table.begin() <= it && !(it < table.begin()));
+        assert(std::distance(table.begin(), table.end()) == static_cast<std::ptrdiff_t>(rows.size()));
+    }
+
+    // padding between the stored elements is written as zeros, the file depends on the rows alone
+    using Stored = Tuple<char, std::uint64_t, Tuple_Traits::MappedStringRef>;
+    const std::string paddedPath = path + ".padded";
+    const bool paddedWritten = writeMappedTable(paddedPath, std::vector<Tuple<char, std::uint64_t, std::string>>{
+            makeTuple('x', std::uint64_t(1), std::string("one"))});
+    assert(paddedWritten);
+    std::ifstream paddedFile(paddedPath, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(paddedFile)), std::istreambuf_iterator<char>());
+    paddedFile.close();
+    std::remove(paddedPath.c_str());
+    Tuple_Traits::MappedTableHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    std::vector<bool> covered(sizeof(Stored), false);
+    const std::size_t elements[][2] = {{tupleOffsetOf<0, Stored>(), tupleSizeOf<0, Stored>()},
+                                       {tupleOffsetOf<1, Stored>(), tupleSizeOf<1, Stored>()},
+                                       {tupleOffsetOf<2, Stored>(), tupleSizeOf<2, Stored>()}};
+    for (const auto& element : elements) {
+        std::fill(covered.begin() + element[0], covered.begin() + element[0] + element[1], true);
+    }
+    assert(tuplePaddingBytes<Stored>() > 0);
+    for (std::size_t i = 0; i < sizeof(Stored); ++i) {
+        assert(covered[i] || bytes[header.rowsOffset + i] == 0);
+    }
+
+    // a string reference past the heap throws when it is read, the other rows stay readable
+    {
+        std::ifstream in(path, std::ios::binary);
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        in.close();
+        const Tuple_Traits::MappedStringRef damaged = {header.heapSize - 2, 5};
+        std::FILE* file = std::fopen(path.c_str(), "r+b");
+        assert(file != nullptr);
+        const std::uint64_t at = header.rowsOffset + 3 * header.rowSize +
+                tupleOffsetOf<1, Tuple<std::uint32_t, Tuple_Traits::MappedStringRef, double>>();
+        const bool patched = std::fseek(file, static_cast<long>(at), SEEK_SET) == 0 &&
+                             std::fwrite(&damaged, sizeof(damaged), 1, file) == 1;
+        std::fclose(file);
+        assert(patched);
+        MappedTupleTable<std::uint32_t, std::string, double> damagedTable(path);
+        assert(damagedTable.valid() && damagedTable.get<1>(4) == get<1>(rows[4]) && damagedTable.get<0>(3) == 3);
+        bool refused = false;
+        try {
+            damagedTable.get<1>(3);
+        } catch (const std::out_of_range&) {
+            refused = true;
+        }
+        assert(refused);
+    }
+
+    // another layout, a truncated file and a missing file are all refused
+    assert(!(MappedTupleTable<std::uint64_t, std::string, double>(path).valid()));
+    assert(!(MappedTupleTable<std::uint32_t, std::string>(path).valid()));
+    {
+        std::FILE* file = std::fopen(path.c_str(), "r+b");
+        assert(file != nullptr);
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fclose(file);
+        const int truncated = truncate(path.c_str(), size - 1);
+        assert(truncated == 0);
+    }
+    assert(!(MappedTupleTable<std::uint32_t, std::string, double>(path).valid()));
+    std::remove(path.c_str());
+    assert(!(MappedTupleTable<std::uint32_t, std::string, double>(path).valid()));
+}
+
+std::size_t countSortFiles(const std::string& directory) {
+    std::size_t count = 0;
+    if (DIR* dir = opendir(directory.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            count += std::string(entry->d_name).compare(0, 11, "tuple_sort_") == 0;
+        }
+        closedir(dir);
+    }
+    return count;
+}
+
+void test_external_sort() {
+    using Row = Tuple<std::uint32_t, std::string>;
+    std::mt19937 random(11);
+    std::vector<Row> rows;
+    for (int i = 0; i < 50000; ++i) {
+        const std::uint32_t key = random() % 5000;
+        rows.emplace_back(key, "value-" + std::to_string(random() % 100));
+    }
+    std::vector<Row> expected = rows;
+    std::sort(expected.begin(), expected.end());
+    const std::size_t leftover = countSortFiles(".");
+
+    // 64 KiB is a few hundred rows per run, a fan-in of 4 forces several merge passes
+    {
+        ExternalSorter<Row> sorter(64 * 1024, ".", std::less<Row>(), 4);
+        sorter.push(rows.begin(), rows.end());
+        sorter.finish();
+        assert(countSortFiles(".") <= leftover + 4);
+        std::vector<Row> sorted;
+        Row row;
+        while (sorter.next(row)) {
+            sorted.push_back(row);
+        }
+        assert(sorter.ok());
+        assert(sorter.runCount() > 16);
+        assert(sorted == expected);
+    }
+    assert(countSortFiles(".") == leftover);
+
+    // descending through the output iterator form
+    std::vector<Row> descending;
+    const auto greater = [](const Row& a, const Row& b) { return b < a; };
+    const bool sortedDown = externalSort(rows.begin(), rows.end(), std::back_inserter(descending), 32 * 1024, ".", greater);
+    assert(sortedDown);
+    assert(std::equal(descending.begin(), descending.end(), expected.rbegin()));
+
+    // fits in the budget, never touches the disk
+    ExternalSorter<Row> small(1 << 20);
+    small.push(rows.begin(), rows.begin() + 100);
+    small.finish();
+    assert(small.runCount() == 0);
+    Row first;
+    const bool smallRead = small.next(first);
+    assert(smallRead && first == *std::min_element(rows.begin(), rows.begin() + 100));
+
+    // an unwritable directory is reported
+    std::vector<Row> lost;
+    const bool sortedLost = externalSort(rows.begin(), rows.end(), std::back_inserter(lost), 1024, "/nonexistent-dir");
+    assert(!sortedLost);
+}
+
+void test_priority_queue() {
+    using Job = Tuple<std::int64_t, std::string>;
+    static_assert(TuplePriorityQueue<Job>::cachesKey(), "integral leading column is cached");
+    static_assert(!TuplePriorityQueue<Job, std::less<Job>, 4, false>::cachesKey(), "cache can be turned off");
+    static_assert(!TuplePriorityQueue<Tuple<std::string>>::cachesKey(), "strings are not cached");
+
+    // same order as std::priority_queue, ties on the cached column fall back to the full row
+    std::mt19937 random(5);
+    TuplePriorityQueue<Job> queue;
+    TuplePriorityQueue<Job, std::less<Job>, 2, false> binary;
+    std::priority_queue<Job> reference;
+    for (int i = 0; i < 2000; ++i) {
+        Job job(static_cast<std::int64_t>(random() % 64) - 32, std::to_string(random() % 10));
+        queue.push(job);
+        binary.push(job);
+        reference.push(job);
+        if (i % 3 == 0) {
+            assert(queue.top() == reference.top() && binary.top() == reference.top());
+            const Job taken = queue.takeTop();
+            assert(taken == reference.top());
+            binary.pop();
+            reference.pop();
+        }
+    }
+    while (!reference.empty()) {
+        assert(queue.top() == reference.top() && binary.top() == reference.top());
+        queue.pop();
+        binary.pop();
+        reference.pop();
+    }
+    assert(queue.empty() && binary.empty());
+
+    // min-queue on doubles with handles: -0.0 and 0.0 tie on the first column
+    TuplePriorityQueue<Tuple<double, int>, std::greater<Tuple<double, int>>, 8> distances;
+    static_assert(decltype(distances)::cachesKey(), "double leading column is cached");
+    const auto a = distances.push(makeTuple(3.5, 1));
+    const auto b = distances.push(makeTuple(-1.25, 2));
+    const auto c = distances.push(makeTuple(0.0, 3));
+    const auto d = distances.push(makeTuple(-0.0, 4));
+    assert(get<1>(distances.top()) == 2);
+    distances.decreaseKey(a, makeTuple(-7.0, 1));
+    assert(distances.topHandle() == a);
+    distances.update(a, makeTuple(100.0, 1));
+    distances.erase(b);
+    assert(!distances.contains(b) && distances.contains(c));
+    const auto zero = distances.takeTop();
+    const auto negativeZero = distances.takeTop();
+    assert(zero == makeTuple(0.0, 3) && negativeZero == makeTuple(-0.0, 4));
+    assert(!distances.contains(d));
+    assert(distances[a] == makeTuple(100.0, 1) && distances.size() == 1);
+    const auto e = distances.push(makeTuple(1.0, 5));
+    assert(e == d && get<1>(distances.top()) == 5);
+
+    // custom order, no key cache
+    const auto byName = [](const Job& x, const Job& y) { return get<1>(x) < get<1>(y); };
+    TuplePriorityQueue<Job, decltype(byName)> named(byName);
+    named.push(Job(1, "b"));
+    named.push(Job(2, "c"));
+    named.push(Job(3, "a"));
+    const Job last = named.takeTop();
+    const Job middle = named.takeTop();
+    assert(get<1>(last) == "c" && get<1>(middle) == "b");
+}
+
+void test_atomic_tuple() {
+    // a hole between the elements, stored as zeros so that compareExchange sees equal rows
+    using State = AtomicTuple<std::uint8_t, std::uint32_t>;
+    State state(makeTuple(std::uint8_t(1), std::uint32_t(10)));
+    assert(state.isLockFree() && State::isAlwaysLockFree());
+    auto expected = makeTuple(std::uint8_t(1), std::uint32_t(10));
+    const bool swapped = state.compareExchange(expected, makeTuple(std::uint8_t(2), std::uint32_t(20)));
+    assert(swapped);
+    const bool swappedAgain = state.compareExchange(expected, makeTuple(std::uint8_t(3), std::uint32_t(30)));
+    assert(!swappedAgain && expected == makeTuple(std::uint8_t(2), std::uint32_t(20)));
+    const auto previous = state.exchange(makeTuple(std::uint8_t(4), std::uint32_t(40)));
+    assert(previous == expected);
+    // element 1 is in the top bytes and takes the fetch_add path, element 0 the CAS loop
+    const std::uint32_t before = state.fetchAdd<1>(2);
+    const std::uint8_t beforeLow = state.fetchAdd<0>(255);
+    assert(before == 40u && beforeLow == 4);
+    assert(state.load() == makeTuple(std::uint8_t(3), std::uint32_t(42)));
+    state.fetchAdd<1>(std::uint32_t(-43));
+    assert(state.load() == makeTuple(std::uint8_t(3), std::uint32_t(-1)));
+
+    // two 8-byte elements: double-width CAS, lock-free only where the target has one
+    int target = 0;
+    AtomicTuple<std::uint64_t, void*> published;
+    assert(published.load() == makeTuple(std::uint64_t(0), static_cast<void*>(nullptr)));
+    published.store(makeTuple(std::uint64_t(7), static_cast<void*>(&target)), std::memory_order_release);
+    assert(get<1>(published.load(std::memory_order_acquire)) == &target);
+
+    AtomicTuple<std::int32_t, std::int32_t> counters;
+    AtomicTuple<double, std::int32_t> sum;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                counters.fetchAdd<0>(1, std::memory_order_relaxed);
+                counters.fetchAdd<1>(-2, std::memory_order_relaxed);
+                sum.fetchAdd<0>(0.5);
+                published.fetchAdd<0>(1);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    assert(counters.load() == makeTuple(40000, -80000));
+    assert(get<0>(sum.load()) == 20000.0);
+    assert(published.load() == makeTuple(std::uint64_t(40007), static_cast<void*>(&target)));
+}
+
+void test_seqlock_tuple() {
+    using Stats = SeqlockTuple<std::uint64_t, std::uint32_t, double, std::uint64_t, char>;
+    Stats stats;
+    assert(stats.read() == Stats::value_type() && stats.version() == 0);
+    stats.write(std::uint64_t(1), std::uint32_t(2), 3.0, std::uint64_t(4), 'x');
+    stats.update<2>(3.5);
+    stats.update<4>('y');
+    assert(stats.read() == makeTuple(std::uint64_t(1), std::uint32_t(2), 3.5, std::uint64_t(4), 'y'));
+    assert(stats.version() == 3);
+
+    // every write keeps all columns equal, so a torn copy would show different values
+    using Wide = SeqlockTuple<std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t, std::uint64_t>;
+    Wide wide;
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            std::uint64_t last = 0;
+            while (!done.load()) {
+                const Wide::value_type row = wide.read();
+                assert(get<0>(row) == get<1>(row) && get<0>(row) == get<2>(row) && get<0>(row) == get<5>(row));
+                assert(get<0>(row) >= last);
+                last = get<0>(row);
+            }
+        });
+    }
+    for (std::uint64_t i = 1; i <= 200000; ++i) {
+        wide.write(i, i, i, i, i, i);
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    assert(get<4>(wide.read()) == 200000);
+}
+
+namespace memo_test {
+    // counts copies, so the test can see that a hit copies no argument
+    struct Name {
+        explicit Name(std::string text) : text(std::move(text)) {}
+
+        Name(const Name& other) : text(other.text) {
+            ++copies;
+        }
+
+        Name& operator=(const Name& other) = default;
+
+        bool operator==(const Name& other) const {
+            return text == other.text;
+        }
+
+        std::string text;
+        static int copies;
+    };
+
+    int Name::copies = 0;
+
+    int calls = 0;
+
+    std::size_t score(const Name& name, int weight) {
+        ++calls;
+        return name.text.size() * weight;
+    }
+}
+
+namespace std {
+    template<>
+    struct hash<memo_test::Name> {
+        std::size_t operator()(const memo_test::Name& name) const {
+            return std::hash<std::string>()(name.text);
+        }
+    };
+}
+
+void test_memoize() {
+    using memo_test::Name;
+    auto score = memoize(memo_test::score, 2);
+    const Name alice("alice"), bob("bob"), carol("carol");
+
+    assert(score(alice, 2) == 10 && score(alice, 2) == 10 && score(alice, 3) == 15);
+    assert(memo_test::calls == 2 && score.hits() == 1 && score.misses() == 2);
+    Name::copies = 0;
+    assert(score(alice, 2) == 10 && Name::copies == 0);
+
+    // full cache: CLOCK skips (alice, 2), used since the last sweep, and evicts (alice, 3)
+    assert(score(bob, 1) == 3 && score.size() == 2);
+    assert(score(alice, 2) == 10 && memo_test::calls == 3);
+    assert(score(alice, 3) == 15 && memo_test::calls == 4);
+    assert(score(carol, 1) == 5 && score(bob, 1) == 3 && memo_test::calls == 6);
+
+    // a lambda, and arguments converted to the parameter type before the lookup
+    int lengths = 0;
+    auto length = memoize([&](const std::string& text) {
+        ++lengths;
+        return text.size();
+    }, 16);
+    assert(length("tuple") == 5 && length(std::string("tuple")) == 5 && lengths == 1);
+
+    auto shared = memoizeConcurrent([](std::uint64_t n, std::uint64_t k) { return n * 31 + k; }, 256, 4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&shared] {
+            for (std::uint64_t i = 0; i < 5000; ++i) {
+                assert(shared(i % 50, i % 3) == (i % 50) * 31 + i % 3);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    assert(shared.hits() + shared.misses() == 20000 && shared.hits() > shared.misses());
+}
+
+namespace construct_test {
+    // neither copyable nor movable, only constructible in place
+    struct Pinned {
+        Pinned(int first, int second) : sum(first + second) {}
+
+        Pinned(const Pinned&) = delete;
+        Pinned& operator=(const Pinned&) = delete;
+
+        int sum;
+    };
+
+    struct Counted {
+        Counted(const char* text) : text(text) {}
+
+        Counted(const Counted& other) : text(other.text) {
+            ++copies;
+        }
+
+        Counted(Counted&& other) noexcept : text(std::move(other.text)) {
+            ++moves;
+        }
+
+        Counted& operator=(const Counted&) = default;
+
+        std::string text;
+        static int copies;
+        static int moves;
+    };
+
+    int Counted::copies = 0;
+    int Counted::moves = 0;
+
+    // a throwing constructor, rebuilt through a temporary so that a throw keeps the old value
+    struct Checked {
+        explicit Checked(int value) : value(value) {
+            if (value < 0) {
+                throw value;
+            }
+        }
+
+        int value;
+    };
+}
+
+void test_construction() {
+    using namespace construct_test;
+
+    Tuple<Pinned, std::string, int> pinned(std::piecewise_construct, std::forward_as_tuple(2, 3),
+                                           std::forward_as_tuple(3, 'x'), std::forward_as_tuple());
+    assert(get<0>(pinned).sum == 5 && get<1>(pinned) == "xxx" && get<2>(pinned) == 0);
+    assert(pinned.emplace<0>(10, 20).sum == 30 && get<0>(pinned).sum == 30);
+    assert(pinned.emplace<1>(2, 'y') == "yy");
+
+    // converting construction builds each element from its argument, no temporary to move
+    Tuple<Counted, long, std::string> converted("tuple", 7, "text");
+    assert(get<0>(converted).text == "tuple" && get<1>(converted) == 7 && get<2>(converted) == "text");
+    assert(Counted::copies == 0 && Counted::moves == 0);
+
+    Tuple<Checked, int> checked(std::piecewise_construct, std::forward_as_tuple(1), std::forward_as_tuple(2));
+    assert(checked.emplace<0>(4).value == 4);
+    bool thrown = false;
+    try {
+        checked.emplace<0>(-1);
+    } catch (int) {
+        thrown = true;
+    }
+    assert(thrown && get<0>(checked).value == 4);
+}
+
+void test_visit() {
+    Tuple<int, double, std::string, char> row(1, 2.5, "three", '4');
+    std::ostringstream out;
+    const auto print = [&out](const auto& value) { out << value << ' '; };
+    for (std::size_t i = 0; i < row.size(); ++i) {
+        visitAt(row, i, print);
+    }
+    assert(out.str() == "1 2.5 three 4 ");
+
+    // results convert to their common type
+    const auto width = visitAt(row, 2, [](const auto& value) { return sizeof(value); });
+    assert(width == sizeof(std::string));
+    assert(visitAt(makeTuple(7, 3.5), 1, [](auto value) { return value * 2; }) == 7.0);
+
+    // elements are reached through the tuple's own value category
+    visitAt(row, 0, [](auto& value) { value += 41; });
+    assert(get<0>(row) == 42);
+    Tuple<std::string, std::string> names("first", "second");
+    const std::string moved = visitAt(std::move(names), 1, [](auto&& value) {
+        return std::string(std::forward<decltype(value)>(value));
+    });
+    assert(moved == "second" && get<1>(names).empty());
+
+    std::ostringstream projected;
+    const std::vector<int> columns = {3, 0, 3};
+    visitColumns(row, columns, [&projected](const auto& value) { projected << value << ','; });
+    visitColumns(row, {1}, [&projected](const auto& value) { projected << value; });
+    assert(projected.str() == "4,42,4,2.5");
+
+    // bad indices throw in every build, before anything is visited
+    int visited = 0;
+    const auto count = [&visited](const auto&) { ++visited; };
+    bool pastEnd = false, negative = false;
+    try {
+        visitAt(row, row.size(), count);
+    } catch (const std::out_of_range&) {
+        pastEnd = true;
+    }
+    try {
+        visitColumns(row, std::vector<int>{-1}, count);
+    } catch (const std::out_of_range&) {
+        negative = true;
+    }
+    assert(pastEnd && negative && visited == 0);
+}
+
+void test_zip() {
+    std::vector<std::uint32_t> ids = {4, 2, 9, 2, 7};
+    std::vector<std::int64_t> times = {40, 21, 90, 20, 70};
+    std::vector<std::string> names = {"d", "b2", "e", "b1", "c"};
+
+    // rows are proxies: writes reach the arrays, copies bind to the same elements
+    auto rows = zip(ids, times, names);
+    assert(rows.size() == 5 && get<2>(rows[1]) == "b2");
+    auto third = rows[2];
+    get<1>(third) += 1;
+    assert(times[2] == 91);
+    rows[2] = makeTuple(std::uint32_t(8), std::int64_t(80), std::string("e"));
+    assert(ids[2] == 8 && times[2] == 80);
+
+    // sorted in place through the proxies and the comparison operators
+    std::sort(rows.begin(), rows.end());
+    assert(ids == std::vector<std::uint32_t>({2, 2, 4, 7, 8}));
+    assert(times == std::vector<std::int64_t>({20, 21, 40, 70, 80}));
+    assert(names == std::vector<std::string>({"b1", "b2", "d", "c", "e"}));
+
+    std::sort(rows.begin(), rows.end(), [](const auto& x, const auto& y) { return get<2>(x) > get<2>(y); });
+    assert(names == std::vector<std::string>({"e", "d", "c", "b2", "b1"}) && ids[0] == 8 && times[4] == 20);
+
+    std::reverse(rows.begin(), rows.end());
+    assert(names.front() == "b1" && ids.front() == 2 && times.back() == 80);
+
+    // larger input against std::sort of materialized rows, the shorter range limits the zip
+    std::mt19937 random(3);
+    std::vector<int> keys(5000), values(5000), extra(4000);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = static_cast<int>(random() % 100);
+        values[i] = static_cast<int>(i);
+    }
+    std::vector<Tuple<int, int>> expected;
+    for (std::size_t i = 0; i < extra.size(); ++i) {
+        expected.emplace_back(keys[i], values[i]);
+    }
+    std::stable_sort(expected.begin(), expected.end(), [](const Tuple<int, int>& x, const Tuple<int, int>& y) {
+        return get<0>(x) < get<0>(y);
+    });
+    auto limited = zip(keys, values, extra);
+    assert(limited.size() == 4000);
+    std::stable_sort(limited.begin(), limited.end(), [](const auto& x, const auto& y) { return get<0>(x) < get<0>(y); });
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        assert(keys[i] == get<0>(expected[i]) && values[i] == get<1>(expected[i]));
+    }
+    assert(std::is_sorted(keys.begin(), keys.begin() + 4000));
+
+    // reading through a prvalue proxy row copies, it never moves out of the ranges
+    std::vector<std::string> sources = {"first", "second"};
+    auto named = zip(ids, sources);
+    const std::string copied = get<1>(*named.begin());
+    const std::string byType = get<std::string&>(std::move(*(named.begin() + 1)));
+    assert(copied == "first" && byType == "second");
+    assert(sources == std::vector<std::string>({"first", "second"}));
+    static_assert(std::is_same<decltype(get<1>(*named.begin())), std::string&>::value, "get: reference element moved");
+    static_assert(std::is_same<decltype(get<0>(Tuple<std::string>())), std::string&&>::value, "get: owned element not moved");
+
+    // assigning zip rows to zip rows copies through the proxies, the source keeps its strings
+    std::vector<std::uint32_t> targetIds(2);
+    std::vector<std::string> targets(2);
+    auto copies = zip(targetIds, targets);
+    std::copy(named.begin(), named.end(), copies.begin());
+    assert(targets == sources && sources == std::vector<std::string>({"first", "second"}));
+    copies[0] = named[1];
+    assert(targets[0] == "second" && sources[1] == "second");
+}
+
+namespace order_test {
+    // collation for the name column
+    struct CaseInsensitive {
+        bool operator()(const std::string& left, const std::string& right) const {
+            return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end(), [](char l, char r) {
+                return std::tolower(static_cast<unsigned char>(l)) < std::tolower(static_cast<unsigned char>(r));
+            });
+        }
+    };
+}
+
+void test_order_by() {
+    using Row = Tuple<int, std::string, double>;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<Row> rows = {Row(1, "b", 2.0), Row(2, "A", nan), Row(1, "a", 1.0), Row(3, "B", nan), Row(2, "c", 0.5)};
+
+    auto sorted = rows;
+    std::sort(sorted.begin(), sorted.end(), orderBy<Desc<0>, Asc<1>>);
+    assert(get<1>(sorted[0]) == "B" && get<1>(sorted[1]) == "A" && get<1>(sorted[2]) == "c");
+    assert(get<1>(sorted[3]) == "a" && get<1>(sorted[4]) == "b");
+
+    std::sort(sorted.begin(), sorted.end(), orderBy<Asc<1, order_test::CaseInsensitive>, Asc<0>>);
+    assert(get<1>(sorted[0]) == "a" && get<1>(sorted[1]) == "A" && get<1>(sorted[2]) == "b" && get<0>(sorted[3]) == 3);
+
+    // NaN is NULL: last, or first ahead of descending values
+    std::sort(sorted.begin(), sorted.end(), orderBy<NullsLast<2>, Asc<0>>);
+    assert(get<2>(sorted[0]) == 0.5 && get<2>(sorted[2]) == 2.0 && get<0>(sorted[3]) == 2 && get<0>(sorted[4]) == 3);
+    std::sort(sorted.begin(), sorted.end(), orderBy<NullsFirst<2, Desc<2>>, Desc<0>>);
+    assert(get<0>(sorted[0]) == 3 && get<0>(sorted[1]) == 2 && get<2>(sorted[2]) == 2.0 && get<2>(sorted[4]) == 0.5);
+
+    int value = 0;
+    std::vector<Tuple<int*, int>> pointers = {Tuple<int*, int>(nullptr, 1), Tuple<int*, int>(&value, 2)};
+    std::sort(pointers.begin(), pointers.end(), orderBy<NullsLast<0, Asc<1>>>);
+    assert(get<1>(pointers[0]) == 2);
+
+    // the same comparator drives heaps, the priority queue and proxy rows from zip
+    using ByKey = OrderBy<Desc<0>, Asc<1>>;
+    static_assert(TuplePriorityQueue<Row, ByKey>::cachesKey(), "a leading Desc<0> keeps the key cache");
+    static_assert(!TuplePriorityQueue<Row, OrderBy<Asc<1>>>::cachesKey(), "other leading keys do not");
+    TuplePriorityQueue<Row, ByKey> queue;
+    auto heap = rows;
+    std::make_heap(heap.begin(), heap.end(), ByKey());
+    for (const Row& row : rows) {
+        queue.push(row);
+    }
+    std::sort(sorted.begin(), sorted.end(), ByKey());
+    for (auto it = sorted.rbegin(); it != sorted.rend(); ++it) {
+        assert(get<1>(queue.takeTop()) == get<1>(*it));
+        std::pop_heap(heap.begin(), heap.end(), ByKey());
+        assert(get<1>(heap.back()) == get<1>(*it));
+        heap.pop_back();
+    }
+
+    std::vector<int> ids = {3, 1, 2};
+    std::vector<std::string> names = {"x", "y", "z"};
+    auto zipped = zip(ids, names);
+    std::sort(zipped.begin(), zipped.end(), orderBy<Desc<0>>);
+    assert(ids == std::vector<int>({3, 2, 1}) && names == std::vector<std::string>({"x", "z", "y"}));
+}
+
+void test_top_k() {
+    using Row = Tuple<int, std::uint32_t, std::string>;
+    std::mt19937 random(8);
+    std::vector<Row> rows;
+    for (std::uint32_t i = 0; i < 20000; ++i) {
+        rows.emplace_back(static_cast<int>(random() % 500) - 250, i, std::to_string(random() % 7));
+    }
+
+    // leading-column filtering for every known direction, and a comparator without one
+    const auto byName = [](const Row& x, const Row& y) {
+        return get<2>(x) < get<2>(y) || (get<2>(x) == get<2>(y) && get<1>(x) < get<1>(y));
+    };
+    for (const std::size_t k : {std::size_t(0), std::size_t(1), std::size_t(100), std::size_t(30000)}) {
+        auto expected = rows;
+        std::sort(expected.begin(), expected.end());
+        expected.resize(std::min(k, expected.size()));
+        assert(topK(rows.begin(), rows.end(), k) == expected);
+        assert(topKParallel(rows.begin(), rows.end(), k, std::less<Row>(), 3) == expected);
+
+        expected = rows;
+        std::sort(expected.begin(), expected.end(), std::greater<Row>());
+        expected.resize(std::min(k, expected.size()));
+        assert(topK(rows.begin(), rows.end(), k, std::greater<Row>()) == expected);
+
+        expected = rows;
+        std::sort(expected.begin(), expected.end(), orderBy<Desc<0>, Asc<1>>);
+        expected.resize(std::min(k, expected.size()));
+        assert(topK(rows.begin(), rows.end(), k, orderBy<Desc<0>, Asc<1>>) == expected);
+
+        expected = rows;
+        std::sort(expected.begin(), expected.end(), byName);
+        expected.resize(std::min(k, expected.size()));
+        assert(topKParallel(rows.begin(), rows.end(), k, byName, 4) == expected);
+    }
+
+    // pushed one by one, rvalues moved in
+    TopK<Row> top(2);
+    top.push(Row(5, 1, "a"));
+    top.push(Row(3, 2, "b"));
+    top.push(Row(4, 3, "c"));
+    top.push(Row(9, 4, "d"));
+    const std::vector<Row> best = top.take();
+    assert(best.size() == 2 && get<0>(best[0]) == 3 && get<0>(best[1]) == 4 && top.size() == 0);
+
+    // no limit: nothing is reserved for rows that never arrive
+    const std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+    auto sorted = rows;
+    std::sort(sorted.begin(), sorted.end());
+    const std::vector<Row> all = topK(rows.begin(), rows.end(), unlimited);
+    const std::vector<Row> allParallel = topKParallel(rows.begin(), rows.end(), unlimited, std::less<Row>(), 2);
+    assert(all == sorted && allParallel == sorted && TopK<Row>(unlimited).k() == unlimited);
+}
+
+void test_lower_bound_batch() {
+    using Row = Tuple<std::int32_t, double, std::uint16_t>;
+    std::mt19937 random(4);
+    // few distinct leading values, so most probes tie on the leading column
+    const auto makeRow = [&random] {
+        return Row(static_cast<std::int32_t>(random() % 64) - 32, static_cast<double>(random() % 4),
+                   static_cast<std::uint16_t>(random() % 3));
+    };
+    for (const std::size_t size : {std::size_t(0), std::size_t(1), std::size_t(2), std::size_t(17), std::size_t(5000)}) {
+        std::vector<Row> rows;
+        for (std::size_t i = 0; i < size; ++i) {
+            rows.push_back(makeRow());
+        }
+        std::sort(rows.begin(), rows.end());
+        std::vector<Row> queries;
+        for (std::size_t i = 0; i < 1000; ++i) {
+            queries.push_back(makeRow());
+        }
+        queries.emplace_back(-100, 0.0, std::uint16_t(0));
+        queries.emplace_back(100, 0.0, std::uint16_t(0));
+
+        std::vector<std::size_t> positions(queries.size());
+        assert(lowerBoundBatch(rows, queries, positions.begin()) == positions.end());
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            const auto expected = std::lower_bound(rows.begin(), rows.end(), queries[i], [](const Row& x, const Row& y) {
+                return Tuple_Traits::lower(x, y);
+            });
+            assert(positions[i] == static_cast<std::size_t>(expected - rows.begin()));
+        }
+    }
+
+    // single column rows, out through an inserter
+    const std::vector<Tuple<std::uint64_t>> keys = {Tuple<std::uint64_t>(2), Tuple<std::uint64_t>(4), Tuple<std::uint64_t>(4)};
+    const std::vector<Tuple<std::uint64_t>> lookups = {Tuple<std::uint64_t>(4), Tuple<std::uint64_t>(1), Tuple<std::uint64_t>(9)};
+    std::vector<std::size_t> found;
+    lowerBoundBatch(keys, lookups, std::back_inserter(found));
+    assert((found == std::vector<std::size_t>{1, 0, 3}));
+}
+
+void test_distinct() {
+    using Row = Tuple<int, std::string>;
+    std::mt19937 random(12);
+    for (const std::size_t size : {std::size_t(0), std::size_t(1), std::size_t(1000), std::size_t(50000)}) {
+        for (const unsigned keys : {3u, 20000u}) {
+            std::vector<Row> rows;
+            for (std::size_t i = 0; i < size; ++i) {
+                const unsigned key = random() % keys;
+                rows.emplace_back(static_cast<int>(key % 97), std::to_string(key));
+            }
+            auto expected = rows;
+            std::sort(expected.begin(), expected.end());
+            expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+            // first occurrences, in input order
+            std::map<Row, std::size_t> firstSeen;
+            for (std::size_t i = 0; i < rows.size(); ++i) {
+                firstSeen.emplace(rows[i], i);
+            }
+            const auto stable = distinctStable(rows);
+            assert(stable.size() == expected.size());
+            for (std::size_t i = 0; i < stable.size(); ++i) {
+                assert(i == 0 || firstSeen[stable[i - 1]] < firstSeen[stable[i]]);
+            }
+
+            auto inPlace = rows;
+            distinct(inPlace);
+            for (auto result : {inPlace, distinctParallel(rows, 3), distinctParallel(rows, 1)}) {
+                assert(result.size() == expected.size());
+                std::sort(result.begin(), result.end());
+                assert(result == expected);
+            }
+        }
+    }
+}
+
+void test_filters() {
+    using Key = Tuple<std::uint64_t, std::string, int>;
+    // pinned values: filters saved by earlier builds must keep answering the same
+    assert(StableTupleHash()(Key(1, "", 0)) == StableTupleHash()(Key(1, std::string(), 0)));
+    assert(StableTupleHash()(Tuple<double>(-0.0)) == StableTupleHash()(Tuple<double>(0.0)));
+    assert(StableTupleHash()(Tuple<int>(-1)) == StableTupleHash()(Tuple<long>(-1)));
+    assert(StableTupleHash()(Key(42, "tenant-7", -3)) == 0x176ed882e50957dfULL);
+    // a byte with the high bit set hashes the same whatever the signedness of char
+    const char high = static_cast<char>(0xE9);
+    assert(StableTupleHash()(Tuple<char>(high)) == StableTupleHash()(Tuple<unsigned char>(0xE9)));
+    assert(StableTupleHash()(Tuple<signed char>(static_cast<signed char>(high))) == StableTupleHash()(Tuple<char>(high)));
+    assert(StableTupleHash()(Tuple<char>(high)) == Tuple_Traits::stableStep(0, 0xE9));
+    assert(StableTupleHash()(Key(42, "tenant-7", -3)) != StableTupleHash()(Key(42, "tenant-7", -3), 1));
+
+    std::vector<Key> inserted, absent;
+    for (std::uint64_t i = 0; i < 20000; ++i) {
+        inserted.emplace_back(i, "tenant-" + std::to_string(i % 13), static_cast<int>(i % 5));
+        absent.emplace_back(i + 1000000, "tenant-" + std::to_string(i % 13), static_cast<int>(i % 5));
+    }
+
+    {
+        BlockedBloomFilter<Key> bloom(inserted.size(), 12);
+        bloom.insertBatch(inserted);
+        for (const Key& key : inserted) {
+            assert(bloom.contains(key));
+        }
+        std::vector<bool> found;
+        bloom.containsBatch(absent, std::back_inserter(found));
+        assert(found.size() == absent.size());
+        std::size_t falsePositives = 0;
+        for (std::size_t i = 0; i < absent.size(); ++i) {
+            assert(found[i] == bloom.contains(absent[i]));
+            falsePositives += found[i];
+        }
+        assert(falsePositives < absent.size() / 50);
+
+        std::ostringstream out;
+        bloom.save(out);
+        const std::string bytes = out.str();
+        BlockedBloomFilter<Key> loaded;
+        bool read = loaded.load(bytes.data(), bytes.size());
+        assert(read);
+        assert(loaded.byteSize() == bloom.byteSize());
+        for (std::size_t i = 0; i < absent.size(); ++i) {
+            assert(loaded.contains(inserted[i]) && loaded.contains(absent[i]) == found[i]);
+        }
+        read = loaded.load(bytes.data(), bytes.size() - 1);
+        assert(!read && loaded.contains(inserted[0]));
+        loaded.clear();
+        assert(!loaded.contains(inserted[0]));
+    }
+
+    {
+        CuckooFilter<Key> cuckoo(inserted.size());
+        const std::size_t batched = cuckoo.insertBatch(inserted);
+        assert(batched == inserted.size() && !cuckoo.full());
+        std::vector<char> found(absent.size());
+        cuckoo.containsBatch(absent, found.begin());
+        std::size_t falsePositives = 0;
+        for (std::size_t i = 0; i < absent.size(); ++i) {
+            assert(cuckoo.contains(inserted[i]));
+            falsePositives += found[i];
+        }
+        assert(falsePositives < 20);
+
+        std::ostringstream out;
+        cuckoo.save(out);
+        const std::string bytes = out.str();
+        CuckooFilter<Key> loaded(1);
+        const bool read = loaded.load(bytes.data(), bytes.size());
+        assert(read && loaded.size() == inserted.size());
+        bool erased = true;
+        for (std::size_t i = 0; i < inserted.size(); i += 2) {
+            erased = loaded.erase(inserted[i]) && erased;
+        }
+        assert(erased);
+        assert(loaded.size() == inserted.size() / 2);
+        for (std::size_t i = 1; i < inserted.size(); i += 2) {
+            assert(loaded.contains(inserted[i]));
+        }
+
+        // filled until an insert fails, nothing inserted before is lost
+        CuckooFilter<Key> small(1000);
+        std::size_t added = 0;
+        while (small.insert(inserted[added])) {
+            ++added;
+        }
+        assert(small.full() && added >= 1000 && small.size() == added);
+        for (std::size_t i = 0; i < added; ++i) {
+            assert(small.contains(inserted[i]));
+        }
+        const bool erasedFirst = small.erase(inserted[0]);
+        const bool room = !small.full();
+        const bool insertedAfter = small.insert(inserted[added]);
+        assert(erasedFirst && room && insertedAfter);
+    }
+}
+
+void test_concurrent_map() {
+    using Key = Tuple<std::string, int>;
+    ConcurrentTupleMap<Key, long> map(4);
+    const bool inserted = map.insertOrAssign(Key("eu", 1), 10L);
+    const bool reinserted = map.insertOrAssign(Key("eu", 1), 11L);
+    assert(inserted && !reinserted);
+    const bool created = map.upsert(Key("us", 2), [](long& value) { value += 5; });
+    const bool recreated = map.upsert(Key("us", 2), [](long& value) { value += 5; });
+    assert(created && !recreated);
+
+    // lookups through a tuple of references build no Key
+    const std::string region = "us";
+    long value = 0;
+    bool found = map.find(Tuple<const std::string&, int>(region, 2), value);
+    assert(found && value == 10);
+    found = map.find(Key("eu", 1), value);
+    assert(found && value == 11);
+    found = map.find(Tuple<const std::string&, int>(region, 3), value);
+    assert(!found);
+    const bool insertedByView = map.insertOrAssign(Tuple<const std::string&, int>(region, 3), 7L);
+    assert(insertedByView && map.contains(Key("us", 3)));
+    assert(map.size() == 3);
+
+    // many entries: growth, erase with backward shift, the last entry moved into holes
+    for (int i = 0; i < 5000; ++i) {
+        map.insertOrAssign(Key("k", i), static_cast<long>(i));
+    }
+    bool erased = true;
+    for (int i = 0; i < 5000; i += 3) {
+        erased = map.erase(Key("k", i)) && erased;
+    }
+    assert(erased);
+    erased = map.erase(Key("k", 0));
+    assert(!erased);
+    for (int i = 0; i < 5000; ++i) {
+        found = map.find(Key("k", i), value);
+        assert(found == (i % 3 != 0) && (i % 3 == 0 || value == i));
+    }
+    long sum = 0;
+    map.forEach([&sum](const Key& key, long v) {
+        sum += get<0>(key) == "k" ? v : 0;
+    });
+    assert(map.size() == 3 + 5000 - 1667 && sum > 0);
+
+    // counters bumped from several threads
+    ConcurrentTupleMap<Tuple<int, int>, long> counters;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counters] {
+            for (int i = 0; i < 20000; ++i) {
+                counters.upsert(Tuple<int, int>(i % 100, i % 7), [](long& count) { ++count; });
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    long total = 0;
+    counters.forEach([&total](const Tuple<int, int>&, long count) {
+        total += count;
+    });
+    assert(total == 4 * 20000 && counters.size() == 700);
+    counters.clear();
+    assert(counters.size() == 0 && !counters.contains(Tuple<int, int>(0, 0)));
+}
+
+void test_scatter_gather() {
+    using Row = Tuple<std::uint32_t, std::string, double, std::vector<std::int16_t>, char>;
+    std::vector<Row> rows;
+    for (int i = 0; i < 1000; ++i) {
+        rows.emplace_back(static_cast<std::uint32_t>(i), std::string(static_cast<std::size_t>(i % 40), 'a' + i % 26),
+                          i * 0.25, std::vector<std::int16_t>(static_cast<std::size_t>(i % 5), static_cast<std::int16_t>(-i)),
+                          static_cast<char>('A' + i % 26));
+    }
+
+    // a local file: single rows, then batches
+    char path[] = "/tmp/tuple_iov_XXXXXX";
+    const int file = mkstemp(path);
+    assert(file >= 0);
+    const bool rowsWritten = writeTuple(file, rows[7]) && writeTuple(file, rows[0]);
+    const bool batchesWritten = writeTuples(file, rows);
+    const off_t rewound = lseek(file, 0, SEEK_SET);
+    assert(rowsWritten && batchesWritten && rewound == 0);
+    Row row;
+    bool readBack = readTuple(file, row);
+    assert(readBack && row == rows[7]);
+    readBack = readTuple(file, row);
+    assert(readBack && row == rows[0]);
+    std::vector<Row> read;
+    while (readTuples(file, read)) {
+    }
+    assert(read == rows);
+    readBack = readTuple(file, row);
+    assert(!readBack);
+    close(file);
+    std::remove(path);
+
+    // a socketpair: more than the socket buffer holds, so writev and readv return short counts
+    int sockets[2];
+    const int paired = socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+    assert(paired == 0);
+    std::vector<Row> many;
+    for (int round = 0; round < 50; ++round) {
+        many.insert(many.end(), rows.begin(), rows.end());
+    }
+    bool sent = false;
+    std::thread writer([&] {
+        sent = writeTuples(sockets[0], many);
+        close(sockets[0]);
+    });
+    std::vector<Row> received;
+    while (received.size() < many.size() && readTuples(sockets[1], received)) {
+    }
+    writer.join();
+    assert(sent && received == many);
+    readBack = readTuples(sockets[1], received);
+    assert(!readBack);
+    close(sockets[1]);
+
+    // a damaged length is refused instead of allocated
+    int stream[2];
+    const int streamPaired = socketpair(AF_UNIX, SOCK_STREAM, 0, stream);
+    assert(streamPaired == 0);
+    const std::uint64_t damaged[2] = {std::uint64_t(1) << 40, 0};
+    const ssize_t damagedWritten = write(stream[0], damaged, sizeof(damaged));
+    assert(damagedWritten == static_cast<ssize_t>(sizeof(damaged)));
+    Tuple<std::string> text;
+    readBack = readTuple(stream[1], text);
+    assert(!readBack);
+    close(stream[0]);
+    close(stream[1]);
+}
+
+void test_dictionary() {
+    StringDictionary dictionary;
+    const StringDictionary::Code at = dictionary.encode("AT");
+    const StringDictionary::Code de = dictionary.encode("DE");
+    assert(at == 0 && de == 1 && dictionary.sorted());
+    const StringDictionary::Code atAgain = dictionary.encode("AT");
+    assert(atAgain == 0 && dictionary.sorted());
+    const StringDictionary::Code ch = dictionary.encode("CH");
+    assert(ch == 2 && !dictionary.sorted());
+    StringDictionary::Code code;
+    bool found = dictionary.find("CH", code);
+    assert(found && code == 2);
+    found = dictionary.find("FR", code);
+    assert(!found);
+    const std::vector<StringDictionary::Code> remap = dictionary.sort();
+    assert(dictionary.sorted() && remap == std::vector<StringDictionary::Code>({0, 2, 1}));
+    found = dictionary.find("DE", code);
+    assert(dictionary[1] == "CH" && found && code == 2);
+    assert(dictionary.lowerBound("B") == 1 && dictionary.lowerBound("ZZ") == 3);
+
+    // many strings, arriving out of order: the index grows, ordering falls back to the strings
+    // until the dictionary is sorted, and agrees with std::string before and after
+    using Plain = Tuple<std::string, int>;
+    using Encoded = Tuple<DictString, int>;
+    std::mt19937 random(7);
+    std::vector<Plain> plain;
+    for (int i = 0; i < 2000; ++i) {
+        plain.emplace_back("status-" + std::to_string(random() % 300), static_cast<int>(random() % 5));
+    }
+    TupleColumns<Encoded> columns;
+    columns.reserve(plain.size());
+    for (const Plain& row : plain) {
+        columns.push_back(row);
+    }
+    assert(columns.size() == plain.size() && !columns.dictionary<0>().sorted());
+    for (int sorted = 0; sorted < 2; ++sorted) {
+        std::vector<Encoded> encoded;
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            encoded.push_back(columns[i]);
+            assert(get<0>(encoded.back()) == get<0>(plain[i]) && encoded.back() == plain[i]);
+        }
+        std::vector<std::size_t> byPlain(plain.size()), byEncoded(plain.size());
+        for (std::size_t i = 0; i < plain.size(); ++i) {
+            byPlain[i] = byEncoded[i] = i;
+        }
+        std::stable_sort(byPlain.begin(), byPlain.end(), [&](std::size_t l, std::size_t r) { return plain[l] < plain[r]; });
+        std::stable_sort(byEncoded.begin(), byEncoded.end(), [&](std::size_t l, std::size_t r) { return encoded[l] < encoded[r]; });
+        assert(byPlain == byEncoded);
+        for (std::size_t i = 0; i < plain.size(); ++i) {
+            assert((encoded[i] == encoded[0]) == (plain[i] == plain[0]));
+            assert(!(encoded[i] == encoded[0]) || TupleHash()(encoded[i]) == TupleHash()(encoded[0]));
+        }
+        columns.sortDictionary<0>();
+        assert(columns.dictionary<0>().sorted());
+    }
+
+    // a range of strings is a range of codes in a sorted dictionary
+    const StringDictionary::Code from = columns.dictionary<0>().lowerBound("status-1");
+    const StringDictionary::Code to = columns.dictionary<0>().lowerBound("status-2");
+    std::size_t inRange = 0;
+    for (const StringDictionary::Code c : columns.column<0>()) {
+        inRange += c >= from && c < to;
+    }
+    assert(inRange == static_cast<std::size_t>(std::count_if(plain.begin(), plain.end(), [](const Plain& row) {
+        return get<0>(row) >= "status-1" && get<0>(row) < "status-2";
+    })));
+
+    // two tables sharing a dictionary hold equal codes for equal strings
+    const std::shared_ptr<StringDictionary> shared = std::make_shared<StringDictionary>();
+    TupleColumns<Tuple<DictString, double>> left;
+    TupleColumns<Tuple<std::uint64_t, DictString>> right;
+    left.setDictionary<0>(shared);
+    right.setDictionary<1>(shared);
+    left.push_back(Tuple<std::string, double>("tenant-a", 1.5));
+    right.push_back(Tuple<std::uint64_t, std::string>(7, "tenant-b"));
+    right.push_back(Tuple<std::uint64_t, DictString>(8, get<0>(left[0])));
+    assert(get<1>(right[1]) == get<0>(left[0]) && get<1>(right[0]) != get<0>(left[0]));
+    assert(shared->size() == 2 && right.column<1>() == std::vector<StringDictionary::Code>({1, 0}));
+
+    // long, repeated strings: codes instead of a std::string and a heap block per row
+    std::vector<Tuple<std::string, std::uint32_t>> wide;
+    TupleColumns<Tuple<DictString, std::uint32_t>> narrow;
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+        wide.emplace_back("a-rather-long-order-status-" + std::to_string(i % 4), i);
+        narrow.push_back(wide.back());
+    }
+    std::size_t wideBytes = wide.capacity() * sizeof(wide[0]);
+    for (const auto& row : wide) {
+        wideBytes += Tuple_Traits::heapBlockBytes(get<0>(row));
+    }
+    assert(narrow.byteSize() * 4 < wideBytes);
+    std::ostringstream out;
+    out << get<0>(narrow[5]);
+    assert(out.str() == "a-rather-long-order-status-1");
+}
+
 int main() {
     test_tuple();
+    test_type_list();
+    test_swap();
+    test_codec();
+    test_mapped();
+    test_external_sort();
+    test_priority_queue();
+    test_atomic_tuple();
+    test_seqlock_tuple();
+    test_memoize();
+    test_construction();
+    test_visit();
+    test_zip();
+    test_order_by();
+    test_top_k();
+    test_lower_bound_batch();
+    test_distinct();
+    test_filters();
+    test_concurrent_map();
+    test_scatter_gather();
+    test_dictionary();
+    test_hash_join();
+    test_layout();
 
     Tuple<int> t = makeTuple(1);
     Tuple<int> tt = Tuple<int>(tt);
@@ -0,0 +1,46 @@
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "tuple.h"
+
+// built with -DTUPLE_TRACE, see CMakeLists.txt
+
+void test_trace() {
+    using Row = Tuple<int, std::string>;
+
+    Tuple_Trace::reset();
+    {
+        Row first(1, std::string("one"));
+        Row second = first;
+        Row third = std::move(first);
+        second = third;
+        third = std::move(second);
+        assert(!(third < third));
+        assert(third.cget() == 1);
+    }
+
+    const Tuple_Trace::Counters counters = Tuple_Trace::counters<Row>();
+    assert(counters[Tuple_Trace::Construct] == 1);
+    assert(counters[Tuple_Trace::Copy] == 1);
+    assert(counters[Tuple_Trace::Move] == 1);
+    assert(counters[Tuple_Trace::CopyAssign] == 1);
+    assert(counters[Tuple_Trace::MoveAssign] == 1);
+    assert(counters[Tuple_Trace::Compare] == 1);
+    assert(counters[Tuple_Trace::ValueCopy] >= 1);
+
+    // the string tail is copied as a base subobject of every Row copy
+    assert(Tuple_Trace::counters<Tuple<std::string>>()[Tuple_Trace::Copy] == 1);
+
+    Tuple_Trace::reset();
+    auto merged = tupleCat(makeTuple(1), makeTuple(2L));
+    assert(get<1>(merged) == 2L);
+    using Merged = Tuple<int, long>;
+    assert(Tuple_Trace::counters<Merged>()[Tuple_Trace::Construct] >= 1);
+}
+
+int main() {
+    test_trace();
+    Tuple_Trace::dumpAtExit();
+    return 0;
+}
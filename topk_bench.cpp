@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tuple_order.h"
+#include "tuple_topk.h"
+
+// Best 100 of 5M scored rows: full std::sort and std::partial_sort of a copy (copy not timed)
+// against topK and topKParallel, not part of the default build:
+//   cmake --build . --target topk_bench && ./topk_bench
+
+namespace {
+    // score, id, label
+    using Row = Tuple<double, std::uint32_t, std::string>;
+    using Best = OrderBy<Desc<0>, Asc<1>>;
+
+    constexpr std::size_t count = 5000000;
+    constexpr std::size_t k = 100;
+
+    std::vector<Row> makeRows() {
+        std::mt19937_64 random(42);
+        std::normal_distribution<double> score(0.0, 1.0);
+        std::vector<Row> rows;
+        rows.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            rows.emplace_back(score(random), static_cast<std::uint32_t>(i), "label-" + std::to_string(i % 5000));
+        }
+        return rows;
+    }
+
+    template<typename F>
+    void report(const char* name, F f) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::vector<Row> best = f();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << name << ": " << ms << " ms (" << get<1>(best.front()) << ", " << get<1>(best.back()) << ")\n";
+    }
+}
+
+int main() {
+    const std::vector<Row> rows = makeRows();
+    const auto noDirection = [](const Row& x, const Row& y) {
+        return Best()(x, y);
+    };
+
+    std::vector<Row> copy = rows;
+    report("std::sort", [&] {
+        std::sort(copy.begin(), copy.end(), Best());
+        return std::vector<Row>(copy.begin(), copy.begin() + k);
+    });
+    copy = rows;
+    report("std::partial_sort", [&] {
+        std::partial_sort(copy.begin(), copy.begin() + k, copy.end(), Best());
+        return std::vector<Row>(copy.begin(), copy.begin() + k);
+    });
+    report("topK, full row comparison", [&] {
+        return topK(rows.begin(), rows.end(), k, noDirection);
+    });
+    report("topK, leading column filter", [&] {
+        return topK(rows.begin(), rows.end(), k, Best());
+    });
+    for (const unsigned threads : {2u, 4u, 8u}) {
+        const std::string name = "topKParallel, " + std::to_string(threads) + " threads";
+        report(name.c_str(), [&] {
+            return topKParallel(rows.begin(), rows.end(), k, Best(), threads);
+        });
+    }
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    return 0;
+}
@@ -3,34 +3,170 @@
 
 #include <iostream>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <tuple>
+#include <utility>
+
+#include "type_list.h"
+
+// -DTUPLE_TRACE counts constructions, copies, moves, assignments and comparisons per Tuple type
+#ifdef TUPLE_TRACE
+#include "tuple_trace.h"
+#define TUPLE_TRACE_BASE(...) , public Tuple_Trace::Hook<__VA_ARGS__>
+#define TUPLE_TRACE_EVENT(event, ...) Tuple_Trace::record<__VA_ARGS__>(Tuple_Trace::event)
+#else
+#define TUPLE_TRACE_BASE(...)
+#define TUPLE_TRACE_EVENT(event, ...) static_cast<void>(0)
+#endif
+
+// Accessors and comparisons are inlined even in unoptimized builds, where a comparison of a wide
+// row would otherwise be a chain of calls per column; artificial lets a debugger step over them.
+// Optimized builds keep the compiler's own inlining decisions. Define TUPLE_NO_FORCE_INLINE to
+// compile them as ordinary functions.
+#if defined(__GNUC__) && !defined(__OPTIMIZE__) && !defined(TUPLE_NO_FORCE_INLINE)
+#define TUPLE_INLINE __attribute__((always_inline, artificial)) inline
+#else
+#define TUPLE_INLINE inline
+#endif
 
 template<typename... T_n>
 class Tuple;
 
+namespace Tuple_Traits {
+    namespace swap_adl {
+        using std::swap;
+
+        template<typename T>
+        struct is_nothrow_swappable
+                : std::integral_constant<bool, noexcept(swap(std::declval<T&>(), std::declval<T&>()))> {};
+
+        // the element's own swap if ADL finds one, std::swap otherwise
+        template<typename T>
+        void swapValues(T& first, T& second) noexcept(is_nothrow_swappable<T>::value) {
+            swap(first, second);
+        }
+    }
+
+    // storage of a reference element: copying the tuple binds the copy to the same objects, while
+    // assignment and swap act on the objects themselves, which makes Tuple<T&...> a proxy row.
+    // Assigning one slot from another copies, even from a temporary proxy, as std::tuple<T&> does:
+    // the temporary does not own the object it refers to.
+    template<typename T>
+    class ReferenceSlot {
+    public:
+        constexpr ReferenceSlot(T& target) noexcept : _target(&target) {}
+
+        constexpr ReferenceSlot(const ReferenceSlot&) = default;
+
+        ReferenceSlot& operator=(const ReferenceSlot& other) {
+            *_target = *other._target;
+            return *this;
+        }
+
+        template<typename V, typename = std::enable_if_t<!std::is_same<std::decay_t<V>, ReferenceSlot>::value>>
+        ReferenceSlot& operator=(V&& value) {
+            *_target = std::forward<V>(value);
+            return *this;
+        }
+
+        constexpr operator T&() const noexcept {
+            return *_target;
+        }
+
+        friend void swap(ReferenceSlot first, ReferenceSlot second) noexcept(swap_adl::is_nothrow_swappable<T>::value) {
+            swap_adl::swapValues(*first._target, *second._target);
+        }
+
+    private:
+        T* _target;
+    };
+
+    template<typename T>
+    struct element_storage {
+        using type = T;
+    };
+
+    template<typename T>
+    struct element_storage<T&> {
+        using type = ReferenceSlot<T>;
+    };
+
+    // trivially copyable with no holes; a base with tail padding may share those bytes with the
+    // members of the derived level, so only padding-free tuples are swapped as raw memory
+    template<typename Tuple, typename... T>
+    constexpr bool isBlockSwappable() {
+        const bool references[] = {false, std::is_reference<T>::value...};
+        const std::size_t sizes[] = {0, sizeof(T)...};
+        std::size_t payload = 0;
+        for (std::size_t i = 0; i < sizeof...(T) + 1; ++i) {
+            if (references[i]) {
+                return false;
+            }
+            payload += sizes[i];
+        }
+        return std::is_trivially_copyable<Tuple>::value && payload == sizeof(Tuple);
+    }
+
+    // selects the constructor that unpacks one level's piecewise arguments
+    struct piecewise_level {
+    };
+
+    // the size is a constant, so each chunk compiles to a few vector loads and stores
+    template<std::size_t Size>
+    void swapBytes(void* first, void* second) noexcept {
+        constexpr std::size_t chunk = Size < 256 ? Size : 256;
+        unsigned char buffer[chunk];
+        unsigned char* left = static_cast<unsigned char*>(first);
+        unsigned char* right = static_cast<unsigned char*>(second);
+        for (std::size_t done = 0; done + chunk <= Size; done += chunk) {
+            std::memcpy(buffer, left + done, chunk);
+            std::memcpy(left + done, right + done, chunk);
+            std::memcpy(right + done, buffer, chunk);
+        }
+        constexpr std::size_t rest = Size % chunk;
+        std::memcpy(buffer, left + Size - rest, rest);
+        std::memcpy(left + Size - rest, right + Size - rest, rest);
+        std::memcpy(right + Size - rest, buffer, rest);
+    }
+}
+
 template<>
 class Tuple<> {
 public:
-    void swap(Tuple<>& other) {}
+    constexpr Tuple() = default;
+
+    explicit constexpr Tuple(std::piecewise_construct_t) {}
+
+    void swap(Tuple<>& other) noexcept {}
 };
 
 template<typename First, typename... T_other>
-class Tuple<First, T_other...> : public  Tuple<T_other...> {
+class Tuple<First, T_other...> : public  Tuple<T_other...> TUPLE_TRACE_BASE(Tuple<First, T_other...>) {
 public:
     using value_type = First;
     using value_reference = First&;
 
     using next_type = Tuple<T_other...>;
 private:
-    value_type _value;
+    typename Tuple_Traits::element_storage<value_type>::type _value;
 public:
     constexpr Tuple() : _value(), Tuple<T_other...>() {}
     explicit constexpr Tuple(const First& first, const T_other&... other) : _value(first), Tuple<T_other...>(other...) {}
 
+    // every element is initialized straight from its argument, whatever it is constructible from
     template<typename Second, typename... S_other, typename = std::enable_if_t<sizeof...(T_other) == sizeof...(S_other)
-            && std::is_same<Second, value_type>::value>>
+            && std::is_constructible<value_type, Second&&>::value && !std::is_same<std::decay_t<Second>, Tuple>::value>>
     explicit constexpr Tuple(Second&& second, S_other&&... other) : _value(std::forward<Second>(second)),
                                                              Tuple<T_other...>(std::forward<S_other>(other)...) {}
 
+    // one std::tuple of constructor arguments per element, usually std::forward_as_tuple(...);
+    // elements are built in place, so they need not be movable
+    template<typename... Args, typename... Rest, typename = std::enable_if_t<sizeof...(Rest) == sizeof...(T_other)>>
+    constexpr Tuple(std::piecewise_construct_t, std::tuple<Args...> arguments, Rest... rest)
+            : Tuple(Tuple_Traits::piecewise_level(), arguments, std::index_sequence_for<Args...>(), std::move(rest)...) {}
+
     Tuple(const Tuple&) = default;
     Tuple(Tuple&&) = default;
 
@@ -46,6 +182,7 @@ public:
 
     template<typename Second, typename... S_other, typename = std::enable_if_t<sizeof...(S_other) == sizeof...(T_other)>>
     Tuple& operator=(const Tuple<Second, S_other...>& other) {
+        TUPLE_TRACE_EVENT(CopyAssign, Tuple<First, T_other...>);
         _value = other.get();
         next() = other.next();
         return *this;
@@ -55,6 +192,7 @@ public:
 
     template<typename Second, typename... S_other, typename = std::enable_if_t<sizeof...(S_other) == sizeof...(T_other)>>
     Tuple& operator=(Tuple<Second, S_other...>&& other) {
+        TUPLE_TRACE_EVENT(MoveAssign, Tuple<First, T_other...>);
         _value = std::move(other.get());
         next() = std::move(other.next());
         return *this;
@@ -62,125 +200,218 @@ public:
 
     ~Tuple() = default;
 
-    constexpr value_reference get() {
+    // destroys element N and constructs it again from args, returns the new element
+    template<int N, typename... Args>
+    decltype(auto) emplace(Args&&... args);
+
+    TUPLE_INLINE constexpr value_reference get() {
+        return _value;
+    }
+
+    TUPLE_INLINE constexpr const value_type& get() const {
         return _value;
     }
 
-    constexpr value_type cget() const {
+    TUPLE_INLINE constexpr value_type cget() const {
+        TUPLE_TRACE_EVENT(ValueCopy, Tuple<First, T_other...>);
         return _value;
     }
 
-    constexpr Tuple<T_other...>& next() {
+    TUPLE_INLINE constexpr Tuple<T_other...>& next() {
         return *static_cast<Tuple<T_other...>*>(this);
     }
 
-    constexpr const Tuple<T_other...>& next() const {
+    TUPLE_INLINE constexpr const Tuple<T_other...>& next() const {
         return *static_cast<const Tuple<T_other...>*>(this);
     }
 
-    void swap(Tuple<First, T_other...>& second) {
-        std::swap(_value, second.get());
-        next().swap(second.next());
+    void swap(Tuple<First, T_other...>& second)
+            noexcept(Tuple_Traits::swap_adl::is_nothrow_swappable<First>::value
+                     && noexcept(std::declval<Tuple<T_other...>&>().swap(std::declval<Tuple<T_other...>&>()))) {
+        swapElements(second, std::integral_constant<bool, Tuple_Traits::isBlockSwappable<Tuple, First, T_other...>()>());
     }
 
     constexpr static std::size_t size() {
         return 1 + sizeof...(T_other);
     }
+
+    // byte offset of this level's element; the tail sub-tuple is the primary base, always at offset 0
+    constexpr static std::size_t valueOffset() {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+        return offsetof(Tuple, _value);
+#pragma GCC diagnostic pop
+    }
+
+private:
+    template<typename Arguments, std::size_t... I, typename... Rest>
+    constexpr Tuple(Tuple_Traits::piecewise_level, Arguments& arguments, std::index_sequence<I...>, Rest&&... rest)
+            : _value(std::forward<std::tuple_element_t<I, Arguments>>(std::get<I>(arguments))...),
+              Tuple<T_other...>(std::piecewise_construct, std::move(rest)...) {}
+
+    void swapElements(Tuple& second, std::true_type) noexcept {
+        if (this != &second) {
+            Tuple_Traits::swapBytes<sizeof(Tuple)>(this, &second);
+        }
+    }
+
+    void swapElements(Tuple& second, std::false_type) noexcept(noexcept(std::declval<Tuple&>().swap(second))) {
+        Tuple_Traits::swap_adl::swapValues(_value, second._value);
+        next().swap(second.next());
+    }
 };
 
 
-// get by type
+namespace Tuple_Traits {
+    template<typename T>
+    struct is_tuple : std::false_type {};
+
+    template<typename... T>
+    struct is_tuple<Tuple<T...>> : std::true_type {};
 
-template<typename T, typename First, typename... T_other>
-constexpr typename std::enable_if_t<std::is_same<T, First>::value, const T&> get(const Tuple<First, T_other...>& tuple) {
-    return tuple.get();
-}
+    template<typename T>
+    struct tuple_types;
 
-template<typename T, typename First, typename... T_other>
-constexpr typename std::enable_if_t<!std::is_same<T, First>::value, const T&> get(const Tuple<First, T_other...>& tuple) {
-    return get<T>(tuple.next());
-}
+    template<typename... T>
+    struct tuple_types<Tuple<T...>> {
+        using type = type_list<T...>;
+    };
 
-template<typename T, typename First, typename... T_other>
-constexpr typename std::enable_if_t<std::is_same<T, First>::value, T&> get(Tuple<First, T_other...>& tuple) {
-    return tuple.get();
-}
+    // the Tuple a type is or derives from, found by the pointer conversion to its base, so classes
+    // derived from a Tuple are read with get<> like the Tuple itself; void for other types
+    template<typename... T>
+    Tuple<T...> tupleBaseOf(const Tuple<T...>*);
 
-template<typename T, typename First, typename... T_other>
-constexpr typename std::enable_if_t<!std::is_same<T, First>::value, T&> get(Tuple<First, T_other...>& tuple) {
-    return get<T>(tuple.next());
-}
+    void tupleBaseOf(const void*);
 
+    template<typename T>
+    using tuple_base_t = decltype(tupleBaseOf(static_cast<const std::decay_t<T>*>(nullptr)));
 
-template<typename T, typename First, typename... T_other>
-constexpr typename std::enable_if_t<std::is_same<T, First>::value, T&&> get(Tuple<First, T_other...>&& tuple) {
-    return std::move(tuple.get());
-}
+    template<typename T>
+    struct is_tuple_based : std::integral_constant<bool, !std::is_void<tuple_base_t<T>>::value> {};
 
-template<typename T, typename First, typename... T_other>
-constexpr typename std::enable_if_t<!std::is_same<T, First>::value, T&&> get(Tuple<First, T_other...>&& tuple) {
-    return get<T>(std::move(tuple.next()));
-}
+    template<typename T>
+    using tuple_types_t = typename tuple_types<tuple_base_t<T>>::type;
+
+    // Tuple<T_N, ...>, the base subobject holding element N
+    template<int N, typename T>
+    struct tuple_tail {
+        using type = rebind_t<Tuple, drop_t<N, tuple_types_t<T>>>;
+    };
+
+    template<int N, typename T>
+    using tuple_tail_t = typename tuple_tail<N, T>::type;
+
+    template<int N, typename T>
+    using tuple_element_t = type_at_t<N, tuple_types_t<T>>;
 
-// get by pos
+    // reference to the tail base with the constness of the owner
+    template<int N, typename T>
+    using tuple_tail_ref_t = std::conditional_t<std::is_const<std::remove_reference_t<T>>::value,
+            const tuple_tail_t<N, T>&, tuple_tail_t<N, T>&>;
 
-template<int N, typename First, typename... T_other, typename = std::enable_if_t<N == 0>>
-constexpr First& get(Tuple<First, T_other...>& tuple) {
-    return tuple.get();
+    // moves the member out of an rvalue owner, otherwise keeps it an lvalue; a reference element
+    // stays an lvalue whatever the owner, as with std::get, since the owner does not own its target
+    template<typename Owner, typename Element, typename T>
+    using forward_member_t = std::conditional_t<std::is_lvalue_reference<Owner>::value || std::is_reference<Element>::value,
+            T&, T&&>;
+
+    template<typename Owner, typename Element, typename T>
+    TUPLE_INLINE constexpr forward_member_t<Owner, Element, T> forwardMember(T& member) {
+        return static_cast<forward_member_t<Owner, Element, T>>(member);
+    }
+
+    template<typename T, typename Tuple>
+    constexpr int tupleIndexOf() {
+        static_assert(index_of<T, tuple_types_t<Tuple>>::value < tuple_types_t<Tuple>::size(), "get: no such type in Tuple");
+        return static_cast<int>(index_of<T, tuple_types_t<Tuple>>::value);
+    }
 }
 
-template<int N, typename First, typename... T_other, typename = std::enable_if_t<N != 0>>
-constexpr decltype(auto) get(Tuple<First, T_other...>& tuple) {
-    return get<N - 1>(tuple.next());
+// found by ADL, so std::sort and other algorithms use the tuple's swap instead of three moves
+template<typename... T_n>
+void swap(Tuple<T_n...>& first, Tuple<T_n...>& second) noexcept(noexcept(first.swap(second))) {
+    first.swap(second);
 }
 
-template<int N, typename First, typename... T_other, typename = std::enable_if_t<N == 0>>
-constexpr const First& get(const Tuple<First, T_other...>& tuple) {
-    return tuple.get();
+// proxy rows such as the ones a zip iterator returns by value swap the objects they refer to
+template<typename... T_n>
+void swap(Tuple<T_n&...>&& first, Tuple<T_n&...>&& second) noexcept(noexcept(first.swap(second))) {
+    first.swap(second);
 }
 
-template<int N, typename First, typename... T_other, typename = std::enable_if_t<N != 0>>
-constexpr decltype(auto) get(const Tuple<First, T_other...>& tuple) {
-    return get<N - 1>(tuple.next());
+// get by pos, a single cast to the base holding element N; one overload per kind serves every
+// value category, which keeps overload resolution cheap on long tuples
+
+template<int N, typename T, typename = std::enable_if_t<Tuple_Traits::is_tuple_based<T>::value>>
+TUPLE_INLINE constexpr decltype(auto) get(T&& tuple) {
+    return Tuple_Traits::forwardMember<T, Tuple_Traits::tuple_element_t<N, T>>(
+            static_cast<Tuple_Traits::tuple_tail_ref_t<N, T>>(tuple).get());
 }
 
-template<int N, typename First, typename... T_other, typename = std::enable_if_t<N == 0>>
-constexpr First&& get(Tuple<First, T_other...>&& tuple) {
-    return std::move(tuple.get());
+// get by type, the first element of type T
+
+template<typename T, typename Owner, typename = std::enable_if_t<Tuple_Traits::is_tuple_based<Owner>::value>>
+TUPLE_INLINE constexpr decltype(auto) get(Owner&& tuple) {
+    return get<Tuple_Traits::tupleIndexOf<T, Owner>()>(std::forward<Owner>(tuple));
 }
 
-template<int N, typename First, typename... T_other, typename = std::enable_if_t<N != 0>>
-constexpr decltype(auto) get(Tuple<First, T_other...>&& tuple) {
-    return get<N - 1>(std::move(tuple.next()));
+
+namespace Tuple_Traits {
+    // a constructor that cannot throw, or an element that cannot be assigned, is rebuilt in the
+    // element's own storage; a throw from there would leave a destroyed element, so it terminates
+    template<typename T, typename... Args>
+    T& reconstruct(T& element, std::true_type, Args&&... args) noexcept {
+        element.~T();
+        return *::new(static_cast<void*>(&element)) T(std::forward<Args>(args)...);
+    }
+
+    // otherwise the new value is built first and moved in, so a throw leaves the old one
+    template<typename T, typename... Args>
+    T& reconstruct(T& element, std::false_type, Args&&... args) {
+        element = T(std::forward<Args>(args)...);
+        return element;
+    }
+}
+
+template<typename First, typename... T_other>
+template<int N, typename... Args>
+decltype(auto) Tuple<First, T_other...>::emplace(Args&&... args) {
+    using Element = Tuple_Traits::tuple_element_t<N, Tuple>;
+    static_assert(!std::is_reference<Element>::value, "emplace: reference elements cannot be rebuilt");
+    constexpr bool inPlace = std::is_nothrow_constructible<Element, Args&&...>::value ||
+                             !std::is_move_assignable<Element>::value;
+    return Tuple_Traits::reconstruct(::get<N>(*this), std::integral_constant<bool, inPlace>(),
+                                     std::forward<Args>(args)...);
 }
 
 
-// operators
+// operators, comparing the elements in place
 namespace Tuple_Traits {
+    template <typename First, typename Second>
+    TUPLE_INLINE constexpr bool lower(const Tuple<First>& first, const Tuple<Second>& second) {
+        return first.get() < second.get();
+    };
+
     template<typename F_first, typename... F_other, typename S_second, typename... S_other,
             typename =std::enable_if_t<sizeof...(F_other) != 0>>
-    constexpr bool lower(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+    TUPLE_INLINE constexpr bool lower(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
         assert(sizeof...(F_other) == sizeof...(S_other));
 
-        return first.cget() < second.cget() || ((first.cget() == second.cget()) && lower(first.next(), second.next()));
+        return first.get() < second.get() || ((first.get() == second.get()) && lower(first.next(), second.next()));
     };
 
     template <typename First, typename Second>
-    constexpr bool lower(const Tuple<First>& first, const Tuple<Second>& second) {
-        return first.cget() < second.cget();
+    TUPLE_INLINE constexpr bool equal(const Tuple<First>& first, const Tuple<Second>& second) {
+        return first.get() == second.get();
     };
 
     template<typename F_first, typename... F_other, typename S_second, typename... S_other,
             typename =std::enable_if_t<sizeof...(F_other) != 0>>
-    constexpr bool equal(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+    TUPLE_INLINE constexpr bool equal(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
         assert(sizeof...(F_other) == sizeof...(S_other));
 
-        return first.cget() == second.cget() && equal(first.next(), second.next());
-    };
-
-    template <typename First, typename Second>
-    constexpr bool equal(const Tuple<First>& first, const Tuple<Second>& second) {
-        return first.cget() == second.cget();
+        return first.get() == second.get() && equal(first.next(), second.next());
     };
 
     template <class T>
@@ -207,26 +438,24 @@ namespace Tuple_Traits {
 
     template<typename... F_other, typename... S_other>
     struct mergeTupleTypes<Tuple<F_other...>, Tuple<S_other...>> {
-        using type = Tuple<F_other..., S_other...>;
+        using type = rebind_t<Tuple, concat_t<type_list<F_other...>, type_list<S_other...>>>;
     };
 
-    template<typename First, typename Second>
-    auto mergeTwoTuples(First&& first, Second&& other,
-                   typename std::enable_if_t<(std::decay_t<First>::size() == 1)>* = 0) {
-        typename mergeTupleTypes<std::decay_t<First>, std::decay_t<Second>>::type result;
-        result.get() = std::forward<typename std::remove_reference_t<First>::value_type>(first.get());
-        result.next() = std::forward<Second>(other);
+    // the second tuple is assigned as a whole to the matching tail base of the result
+    template<typename Result, typename First, typename Second, std::size_t... I>
+    constexpr Result mergeTwoTuples(First&& first, Second&& other, std::index_sequence<I...>) {
+        Result result;
+        static_cast<tuple_tail_t<sizeof...(I), Result>&>(result) = std::forward<Second>(other);
+        const int assigned[] = {0, (get<I>(result) = forwardMember<First, tuple_element_t<I, First>>(get<I>(first)), 0)...};
+        static_cast<void>(assigned);
         return result;
     }
 
-    template<typename First, typename Second, typename = std::enable_if_t<(std::decay_t<First>::size() > 1)>>
+    template<typename First, typename Second>
     constexpr auto mergeTwoTuples(First&& first, Second&& other) {
-        typename mergeTupleTypes<std::decay_t<First>, std::decay_t<Second>>::type result;
-        result.get() = std::forward<typename std::remove_reference_t<First>::value_type>(first.get());
-
-        using next_type = typename std::remove_reference_t<First>::next_type;
-        result.next() = mergeTwoTuples(std::forward<next_type>(first.next()), std::forward<Second>(other));
-        return result;
+        using Result = typename mergeTupleTypes<std::decay_t<First>, std::decay_t<Second>>::type;
+        return mergeTwoTuples<Result>(std::forward<First>(first), std::forward<Second>(other),
+                                      std::make_index_sequence<std::decay_t<First>::size()>());
     }
 }
 
@@ -237,32 +466,34 @@ constexpr auto makeTuple(S_other&&... other) {
 // < > == !=
 
 template<typename F_first, typename... F_other, typename S_second, typename... S_other>
-constexpr bool operator<(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+TUPLE_INLINE constexpr bool operator<(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+    TUPLE_TRACE_EVENT(Compare, Tuple<F_first, F_other...>);
     return Tuple_Traits::lower(first, second);
 }
 
 template<typename F_first, typename... F_other, typename S_second, typename... S_other>
-constexpr bool operator==(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+TUPLE_INLINE constexpr bool operator==(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+    TUPLE_TRACE_EVENT(Compare, Tuple<F_first, F_other...>);
     return Tuple_Traits::equal(first, second);
 }
 
 template<typename F_first, typename... F_other, typename S_second, typename... S_other>
-constexpr bool operator!=(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+TUPLE_INLINE constexpr bool operator!=(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
     return !(first == second);
 }
 
 template<typename F_first, typename... F_other, typename S_second, typename... S_other>
-constexpr bool operator>(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+TUPLE_INLINE constexpr bool operator>(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
     return !(first == second || first < second);
 }
 
 template<typename F_first, typename... F_other, typename S_second, typename... S_other>
-constexpr bool operator<=(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+TUPLE_INLINE constexpr bool operator<=(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
     return first < second || first == second;
 }
 
 template<typename F_first, typename... F_other, typename S_second, typename... S_other>
-constexpr bool operator>=(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
+TUPLE_INLINE constexpr bool operator>=(const Tuple<F_first, F_other...>& first, const Tuple<S_second, S_other...>& second) {
     return first > second || first == second;
 }
 
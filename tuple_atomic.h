@@ -0,0 +1,246 @@
+#ifndef TUPLE_TUPLE_ATOMIC_H
+#define TUPLE_TUPLE_ATOMIC_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "tuple.h"
+
+namespace Tuple_Traits {
+    // smallest unsigned word that a single compare-and-swap covers; 16 bytes needs a double-width CAS
+    template<std::size_t Size>
+    struct atomic_word {
+        static_assert(Size <= 16, "AtomicTuple: tuples wider than 16 bytes have no CAS");
+        using type = std::conditional_t<(Size <= 1), std::uint8_t,
+                     std::conditional_t<(Size <= 2), std::uint16_t,
+                     std::conditional_t<(Size <= 4), std::uint32_t,
+                     std::conditional_t<(Size <= 8), std::uint64_t, unsigned __int128>>>>;
+    };
+
+    template<std::size_t Size>
+    using atomic_word_t = typename atomic_word<Size>::type;
+
+    constexpr int memoryOrder(std::memory_order order) {
+        return static_cast<int>(order);
+    }
+
+    // a failed CAS only loads, so it may not be release or acq_rel
+    constexpr std::memory_order failureOrder(std::memory_order order) {
+        return order == std::memory_order_acq_rel ? std::memory_order_acquire
+             : order == std::memory_order_release ? std::memory_order_relaxed : order;
+    }
+
+    // word operations on the __atomic builtins
+    template<typename Word>
+    struct atomic_ops {
+        constexpr static bool alwaysLockFree() {
+            return __atomic_always_lock_free(sizeof(Word), 0);
+        }
+
+        static bool lockFree(const Word* word) {
+            return __atomic_is_lock_free(sizeof(Word), word);
+        }
+
+        static Word load(const Word* word, std::memory_order order) {
+            return __atomic_load_n(const_cast<Word*>(word), memoryOrder(order));
+        }
+
+        static void store(Word* word, Word value, std::memory_order order) {
+            __atomic_store_n(word, value, memoryOrder(order));
+        }
+
+        static Word exchange(Word* word, Word value, std::memory_order order) {
+            return __atomic_exchange_n(word, value, memoryOrder(order));
+        }
+
+        static bool compareExchange(Word* word, Word& expected, Word desired, bool weak, std::memory_order order) {
+            return __atomic_compare_exchange_n(word, &expected, desired, weak, memoryOrder(order),
+                                               memoryOrder(failureOrder(order)));
+        }
+    };
+
+#ifdef TUPLE_ATOMIC_CX16
+#ifndef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_16
+#error "TUPLE_ATOMIC_CX16 needs a 16-byte __sync compare-and-swap, e.g. -mcx16"
+#endif
+    // Only with TUPLE_ATOMIC_CX16, defined for the whole program rather than decided by -mcx16 per
+    // file: the two implementations do not lock alike, so every access to a row must use the same
+    // one. The compiler inlines cmpxchg16b for the __sync builtins only, the __atomic ones still go
+    // through libatomic, which does not count itself lock-free for 16 bytes. Every operation is
+    // then a full-barrier CAS, at least as strong as any memory order asked for; a load writes the
+    // value it read back, so the row cannot live in read-only memory
+    template<>
+    struct atomic_ops<unsigned __int128> {
+        using Word = unsigned __int128;
+
+        constexpr static bool alwaysLockFree() {
+            return true;
+        }
+
+        static bool lockFree(const Word*) {
+            return true;
+        }
+
+        static Word load(const Word* word, std::memory_order) {
+            return __sync_val_compare_and_swap(const_cast<Word*>(word), Word(0), Word(0));
+        }
+
+        static void store(Word* word, Word value, std::memory_order order) {
+            exchange(word, value, order);
+        }
+
+        static Word exchange(Word* word, Word value, std::memory_order order) {
+            Word current = load(word, order);
+            while (!compareExchange(word, current, value, false, order)) {
+            }
+            return current;
+        }
+
+        static bool compareExchange(Word* word, Word& expected, Word desired, bool, std::memory_order) {
+            const Word previous = __sync_val_compare_and_swap(word, expected, desired);
+            if (previous == expected) {
+                return true;
+            }
+            expected = previous;
+            return false;
+        }
+    };
+#endif
+
+    template<typename Word, typename Row, std::size_t... I>
+    void packElements(Word& word, const Row& row, std::index_sequence<I...>) {
+        const int copied[] = {0, (std::memcpy(reinterpret_cast<unsigned char*>(&word) + tuple_tail_t<I, Row>::valueOffset(),
+                                              &get<I>(row), sizeof(tuple_element_t<I, Row>)), 0)...};
+        static_cast<void>(copied);
+    }
+
+    // copies element by element into a zeroed word, so padding never makes equal rows compare unequal
+    template<typename Word, typename Row>
+    Word packAtomic(const Row& row) {
+        Word word = 0;
+        packElements(word, row, std::make_index_sequence<Row::size()>());
+        return word;
+    }
+
+    template<typename Row, typename Word>
+    Row unpackAtomic(const Word& word) {
+        Row row;
+        std::memcpy(static_cast<void*>(&row), &word, sizeof(Row));
+        return row;
+    }
+}
+
+// Lock-free publication of small trivially-copyable rows, e.g. Tuple<uint32_t, uint32_t> or
+// Tuple<uint64_t, void*>. The row lives in one machine word of 1 to 16 bytes and every operation
+// is a single atomic access or a CAS loop on it. Rows of 9 to 16 bytes need a double-width CAS:
+// with TUPLE_ATOMIC_CX16 defined project-wide (the CMake build does so where -mcx16 works) that is
+// an inlined cmpxchg16b, otherwise the operations go through libatomic and isLockFree() reports
+// what it says. Like std::atomic,
+// compareExchange() compares bits, so 0.0 and -0.0 differ; padding is always stored as zeros.
+template<typename... T>
+class AtomicTuple {
+public:
+    using value_type = Tuple<T...>;
+
+private:
+    static_assert(std::is_trivially_copyable<value_type>::value, "AtomicTuple: elements must be trivially copyable");
+    using Word = Tuple_Traits::atomic_word_t<sizeof(value_type)>;
+    using Ops = Tuple_Traits::atomic_ops<Word>;
+
+public:
+    AtomicTuple() noexcept : _word(Tuple_Traits::packAtomic<Word>(value_type())) {}
+
+    explicit AtomicTuple(const value_type& value) noexcept : _word(Tuple_Traits::packAtomic<Word>(value)) {}
+
+    AtomicTuple(const AtomicTuple&) = delete;
+    AtomicTuple& operator=(const AtomicTuple&) = delete;
+
+    constexpr static bool isAlwaysLockFree() {
+        return Ops::alwaysLockFree();
+    }
+
+    bool isLockFree() const noexcept {
+        return Ops::lockFree(&_word);
+    }
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return Tuple_Traits::unpackAtomic<value_type>(Ops::load(&_word, order));
+    }
+
+    void store(const value_type& value, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        Ops::store(&_word, Tuple_Traits::packAtomic<Word>(value), order);
+    }
+
+    value_type exchange(const value_type& value, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return Tuple_Traits::unpackAtomic<value_type>(Ops::exchange(&_word, Tuple_Traits::packAtomic<Word>(value), order));
+    }
+
+    // on failure `expected` receives the current row
+    bool compareExchange(value_type& expected, const value_type& desired,
+                         std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return compareExchange(expected, desired, false, order);
+    }
+
+    // may fail spuriously, for retry loops
+    bool compareExchangeWeak(value_type& expected, const value_type& desired,
+                             std::memory_order order = std::memory_order_seq_cst) noexcept {
+        return compareExchange(expected, desired, true, order);
+    }
+
+    // adds to element N and returns its previous value. An integral element in the most
+    // significant bytes of a word of 8 bytes or less takes a single fetch_add, the carry leaves the
+    // word; any other element is updated by a CAS loop
+    template<int N>
+    Tuple_Traits::tuple_element_t<N, value_type> fetchAdd(Tuple_Traits::tuple_element_t<N, value_type> delta,
+                                                          std::memory_order order = std::memory_order_seq_cst) noexcept {
+        using Element = Tuple_Traits::tuple_element_t<N, value_type>;
+        static_assert(std::is_arithmetic<Element>::value && !std::is_same<Element, bool>::value,
+                      "AtomicTuple::fetchAdd: element is not a number");
+        return fetchAdd<N>(delta, order, std::integral_constant<bool, topElement<N>()>());
+    }
+
+private:
+    // element N fills the high bytes of the word on a little-endian target
+    template<int N>
+    constexpr static bool topElement() {
+        using Element = Tuple_Traits::tuple_element_t<N, value_type>;
+        return __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && std::is_integral<Element>::value && sizeof(Word) <= 8 &&
+               Tuple_Traits::tuple_tail_t<N, value_type>::valueOffset() + sizeof(Element) == sizeof(Word);
+    }
+
+    template<int N, typename Element>
+    Element fetchAdd(Element delta, std::memory_order order, std::true_type) noexcept {
+        constexpr std::size_t shift = Tuple_Traits::tuple_tail_t<N, value_type>::valueOffset() * 8;
+        const Word addend = static_cast<Word>(static_cast<std::make_unsigned_t<Element>>(delta)) << shift;
+        const Word previous = __atomic_fetch_add(&_word, addend, Tuple_Traits::memoryOrder(order));
+        return get<N>(Tuple_Traits::unpackAtomic<value_type>(previous));
+    }
+
+    template<int N, typename Element>
+    Element fetchAdd(Element delta, std::memory_order order, std::false_type) noexcept {
+        value_type current = load(std::memory_order_relaxed);
+        value_type next;
+        do {
+            next = current;
+            get<N>(next) = static_cast<Element>(get<N>(current) + delta);
+        } while (!compareExchange(current, next, true, order));
+        return get<N>(current);
+    }
+
+    bool compareExchange(value_type& expected, const value_type& desired, bool weak, std::memory_order order) noexcept {
+        Word current = Tuple_Traits::packAtomic<Word>(expected);
+        if (Ops::compareExchange(&_word, current, Tuple_Traits::packAtomic<Word>(desired), weak, order)) {
+            return true;
+        }
+        expected = Tuple_Traits::unpackAtomic<value_type>(current);
+        return false;
+    }
+
+    alignas(sizeof(Word)) Word _word;
+};
+
+#endif //TUPLE_TUPLE_ATOMIC_H
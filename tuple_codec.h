@@ -0,0 +1,490 @@
+#ifndef TUPLE_TUPLE_CODEC_H
+#define TUPLE_TUPLE_CODEC_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+
+// Column-wise compressed encoding for streams of Tuples, meant for sorted rows (timestamps, ids,
+// small counters, repeated strings). Rows are cut into blocks; every block stores each column on
+// its own and starts from scratch, so a reader can jump to any block.
+//
+//   block      varint rows, then per column: varint bytes, column data
+//   directory  varint blocks, then per block: varint byte offset, varint rows
+//   footer     8-byte little-endian directory offset, "TPLZ"
+//
+// Column data is a sequence of groups, each led by a varint header: (n << 1) | 1 is a run of n
+// equal items stored once, n << 1 is n items stored one after another. The items are
+//   integers   zigzag varint of the difference to the previous value, so a run is a constant stride
+//   strings    varint shared prefix with the previous value, varint suffix length, suffix bytes
+//   others     the raw bytes of trivially copyable values
+
+namespace Tuple_Traits {
+    constexpr std::size_t codecRunMin = 3;
+    constexpr char codecMagic[4] = {'T', 'P', 'L', 'Z'};
+
+    inline void putVarint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    inline bool getVarint(const unsigned char*& in, const unsigned char* end, std::uint64_t& value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && in != end; shift += 7) {
+            const unsigned char byte = *in++;
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr std::uint64_t zigzag(std::uint64_t delta) {
+        return (delta << 1) ^ (0 - (delta >> 63));
+    }
+
+    constexpr std::uint64_t unzigzag(std::uint64_t value) {
+        return (value >> 1) ^ (0 - (value & 1));
+    }
+
+    // equal(i) tells whether item i repeats item i - 1, put(i) appends item i
+    template<typename Equal, typename Put>
+    void encodeRuns(std::string& out, std::size_t count, Equal equal, Put put) {
+        std::size_t i = 0;
+        while (i < count) {
+            std::size_t run = 1;
+            while (i + run < count && equal(i + run)) {
+                ++run;
+            }
+            if (run >= codecRunMin) {
+                putVarint(out, (static_cast<std::uint64_t>(run) << 1) | 1);
+                put(i);
+                i += run;
+                continue;
+            }
+            // literals up to the next run worth encoding
+            std::size_t end = i + run;
+            while (end < count) {
+                std::size_t next = 1;
+                while (end + next < count && next < codecRunMin && equal(end + next)) {
+                    ++next;
+                }
+                if (next >= codecRunMin) {
+                    break;
+                }
+                end += next;
+            }
+            putVarint(out, static_cast<std::uint64_t>(end - i) << 1);
+            for (; i < end; ++i) {
+                put(i);
+            }
+        }
+    }
+
+    // get(i) reads item i, repeat(i) makes item i equal to item i - 1
+    template<typename Get, typename Repeat>
+    bool decodeRuns(const unsigned char*& in, const unsigned char* end, std::size_t count, Get get, Repeat repeat) {
+        std::size_t i = 0;
+        while (i < count) {
+            std::uint64_t header;
+            if (!getVarint(in, end, header) || (header >> 1) == 0 || (header >> 1) > count - i) {
+                return false;
+            }
+            const std::size_t length = static_cast<std::size_t>(header >> 1);
+            if (!get(i)) {
+                return false;
+            }
+            if (header & 1) {
+                for (std::size_t j = i + 1; j < i + length; ++j) {
+                    repeat(j);
+                }
+            } else {
+                for (std::size_t j = i + 1; j < i + length; ++j) {
+                    if (!get(j)) {
+                        return false;
+                    }
+                }
+            }
+            i += length;
+        }
+        return true;
+    }
+
+    template<typename T, typename = void>
+    struct ColumnCodec {
+        static_assert(std::is_trivially_copyable<T>::value, "ColumnCodec: no encoding for this element type");
+
+        static void encode(std::string& out, const std::vector<T>& values) {
+            encodeRuns(out, values.size(), [&](std::size_t i) {
+                return std::memcmp(&values[i], &values[i - 1], sizeof(T)) == 0;
+            }, [&](std::size_t i) {
+                out.append(reinterpret_cast<const char*>(&values[i]), sizeof(T));
+            });
+        }
+
+        static bool decode(const unsigned char*& in, const unsigned char* end, std::vector<T>& values) {
+            return decodeRuns(in, end, values.size(), [&](std::size_t i) {
+                if (static_cast<std::size_t>(end - in) < sizeof(T)) {
+                    return false;
+                }
+                std::memcpy(&values[i], in, sizeof(T));
+                in += sizeof(T);
+                return true;
+            }, [&](std::size_t i) {
+                values[i] = values[i - 1];
+            });
+        }
+    };
+
+    template<typename T>
+    struct ColumnCodec<T, std::enable_if_t<std::is_integral<T>::value>> {
+        // differences are taken modulo 2^64, sign extension keeps small negative steps small
+        static std::uint64_t widen(T value) {
+            return static_cast<std::uint64_t>(static_cast<std::conditional_t<std::is_signed<T>::value,
+                    std::int64_t, std::uint64_t>>(value));
+        }
+
+        static void encode(std::string& out, const std::vector<T>& values) {
+            std::vector<std::uint64_t> deltas(values.size());
+            std::uint64_t previous = 0;
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                deltas[i] = zigzag(widen(values[i]) - previous);
+                previous = widen(values[i]);
+            }
+            encodeRuns(out, deltas.size(), [&](std::size_t i) {
+                return deltas[i] == deltas[i - 1];
+            }, [&](std::size_t i) {
+                putVarint(out, deltas[i]);
+            });
+        }
+
+        static bool decode(const unsigned char*& in, const unsigned char* end, std::vector<T>& values) {
+            std::uint64_t previous = 0;
+            std::uint64_t delta = 0;
+            return decodeRuns(in, end, values.size(), [&](std::size_t i) {
+                if (!getVarint(in, end, delta)) {
+                    return false;
+                }
+                delta = unzigzag(delta);
+                previous += delta;
+                values[i] = static_cast<T>(previous);
+                return true;
+            }, [&](std::size_t i) {
+                previous += delta;
+                values[i] = static_cast<T>(previous);
+            });
+        }
+    };
+
+    template<>
+    struct ColumnCodec<std::string> {
+        static void encode(std::string& out, const std::vector<std::string>& values) {
+            encodeRuns(out, values.size(), [&](std::size_t i) {
+                return values[i] == values[i - 1];
+            }, [&](std::size_t i) {
+                std::size_t shared = 0;
+                if (i > 0) {
+                    const std::string& previous = values[i - 1];
+                    const std::size_t limit = std::min(previous.size(), values[i].size());
+                    while (shared < limit && previous[shared] == values[i][shared]) {
+                        ++shared;
+                    }
+                }
+                putVarint(out, shared);
+                putVarint(out, values[i].size() - shared);
+                out.append(values[i], shared, std::string::npos);
+            });
+        }
+
+        static bool decode(const unsigned char*& in, const unsigned char* end, std::vector<std::string>& values) {
+            return decodeRuns(in, end, values.size(), [&](std::size_t i) {
+                std::uint64_t shared, suffix;
+                if (!getVarint(in, end, shared) || !getVarint(in, end, suffix) ||
+                    shared > (i > 0 ? values[i - 1].size() : 0) || suffix > static_cast<std::uint64_t>(end - in)) {
+                    return false;
+                }
+                if (i > 0) {
+                    values[i].assign(values[i - 1], 0, static_cast<std::size_t>(shared));
+                } else {
+                    values[i].clear();
+                }
+                values[i].append(reinterpret_cast<const char*>(in), static_cast<std::size_t>(suffix));
+                in += suffix;
+                return true;
+            }, [&](std::size_t i) {
+                values[i] = values[i - 1];
+            });
+        }
+    };
+
+    inline void putFixed64(std::string& out, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    inline std::uint64_t getFixed64(const unsigned char* in) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+        }
+        return value;
+    }
+
+    struct CodecBlock {
+        std::uint64_t offset;
+        std::uint64_t firstRow;
+        std::uint64_t rows;
+    };
+}
+
+template<typename Row>
+class TupleEncoder;
+
+// writes rows to `out` in blocks of rowsPerBlock; finish() (or the destructor) writes the directory
+template<typename... T>
+class TupleEncoder<Tuple<T...>> {
+public:
+    using Row = Tuple<T...>;
+
+    explicit TupleEncoder(std::ostream& out, std::size_t rowsPerBlock = 4096) : _out(out), _rowsPerBlock(rowsPerBlock) {
+        assert(rowsPerBlock > 0);
+    }
+
+    TupleEncoder(const TupleEncoder&) = delete;
+    TupleEncoder& operator=(const TupleEncoder&) = delete;
+
+    ~TupleEncoder() {
+        finish();
+    }
+
+    void append(const Row& row) {
+        assert(!_finished);
+        appendColumns(row, std::index_sequence_for<T...>());
+        if (++_rows == _rowsPerBlock) {
+            flush();
+        }
+    }
+
+    void finish() {
+        if (_finished) {
+            return;
+        }
+        flush();
+        std::string directory;
+        Tuple_Traits::putVarint(directory, _blocks.size());
+        for (const Tuple_Traits::CodecBlock& block : _blocks) {
+            Tuple_Traits::putVarint(directory, block.offset);
+            Tuple_Traits::putVarint(directory, block.rows);
+        }
+        Tuple_Traits::putFixed64(directory, _written);
+        directory.append(Tuple_Traits::codecMagic, sizeof(Tuple_Traits::codecMagic));
+        _out.write(directory.data(), static_cast<std::streamsize>(directory.size()));
+        _finished = true;
+    }
+
+    // bytes written so far, the directory included once finished
+    std::uint64_t bytesWritten() const {
+        return _written;
+    }
+
+private:
+    template<std::size_t... I>
+    void appendColumns(const Row& row, std::index_sequence<I...>) {
+        const int pushed[] = {0, (get<I>(_columns).push_back(get<I>(row)), 0)...};
+        static_cast<void>(pushed);
+    }
+
+    template<std::size_t... I>
+    void encodeColumns(std::string& block, std::index_sequence<I...>) {
+        std::string column;
+        const int encoded[] = {0, (column.clear(),
+                Tuple_Traits::ColumnCodec<T>::encode(column, get<I>(_columns)),
+                Tuple_Traits::putVarint(block, column.size()),
+                block.append(column),
+                get<I>(_columns).clear(), 0)...};
+        static_cast<void>(encoded);
+    }
+
+    void flush() {
+        if (_rows == 0) {
+            return;
+        }
+        std::string block;
+        Tuple_Traits::putVarint(block, _rows);
+        encodeColumns(block, std::index_sequence_for<T...>());
+        _blocks.push_back({_written, 0, _rows});
+        _out.write(block.data(), static_cast<std::streamsize>(block.size()));
+        _written += block.size();
+        _rows = 0;
+    }
+
+    std::ostream& _out;
+    std::size_t _rowsPerBlock;
+    std::size_t _rows = 0;
+    std::uint64_t _written = 0;
+    bool _finished = false;
+    Tuple<std::vector<T>...> _columns;
+    std::vector<Tuple_Traits::CodecBlock> _blocks;
+};
+
+template<typename Row>
+class TupleDecoder;
+
+// reads an encoded stream held in memory; the bytes must outlive the decoder
+template<typename... T>
+class TupleDecoder<Tuple<T...>> {
+public:
+    using Row = Tuple<T...>;
+
+    TupleDecoder(const void* data, std::size_t size) : _data(static_cast<const unsigned char*>(data)), _size(size) {
+        _valid = readDirectory();
+    }
+
+    // false when the footer or directory is damaged
+    bool valid() const {
+        return _valid;
+    }
+
+    std::uint64_t size() const {
+        return _blocks.empty() ? 0 : _blocks.back().firstRow + _blocks.back().rows;
+    }
+
+    std::size_t blockCount() const {
+        return _blocks.size();
+    }
+
+    // next row in stream order, false at the end or on a damaged block
+    bool next(Row& row) {
+        if (_row == _blockRows) {
+            const std::size_t following = _loaded ? _block + 1 : 0;
+            if (following >= _blocks.size() || !loadBlock(following)) {
+                return false;
+            }
+        }
+        readRow(row, std::index_sequence_for<T...>());
+        ++_row;
+        return true;
+    }
+
+    // positions the decoder so that next() returns row `index`, decoding only the block holding it
+    bool seek(std::uint64_t index) {
+        if (index >= size()) {
+            return false;
+        }
+        const auto block = std::upper_bound(_blocks.begin(), _blocks.end(), index,
+                [](std::uint64_t i, const Tuple_Traits::CodecBlock& b) { return i < b.firstRow; }) - 1;
+        const std::size_t number = static_cast<std::size_t>(block - _blocks.begin());
+        if (!(_loaded && number == _block) && !loadBlock(number)) {
+            return false;
+        }
+        _row = static_cast<std::size_t>(index - block->firstRow);
+        return true;
+    }
+
+private:
+    bool readDirectory() {
+        const std::size_t footer = 8 + sizeof(Tuple_Traits::codecMagic);
+        if (_size < footer || std::memcmp(_data + _size - 4, Tuple_Traits::codecMagic, 4) != 0) {
+            return false;
+        }
+        const std::uint64_t offset = Tuple_Traits::getFixed64(_data + _size - footer);
+        if (offset > _size - footer) {
+            return false;
+        }
+        const unsigned char* in = _data + offset;
+        const unsigned char* end = _data + _size - footer;
+        std::uint64_t count;
+        if (!Tuple_Traits::getVarint(in, end, count) || count > static_cast<std::uint64_t>(end - in)) {
+            return false;
+        }
+        _blocks.resize(static_cast<std::size_t>(count));
+        std::uint64_t firstRow = 0;
+        for (Tuple_Traits::CodecBlock& block : _blocks) {
+            if (!Tuple_Traits::getVarint(in, end, block.offset) || !Tuple_Traits::getVarint(in, end, block.rows) ||
+                block.offset >= offset) {
+                return false;
+            }
+            block.firstRow = firstRow;
+            firstRow += block.rows;
+        }
+        _blocksEnd = offset;
+        return in == end;
+    }
+
+    template<std::size_t... I>
+    bool decodeColumns(const unsigned char* in, const unsigned char* end, std::size_t rows, std::index_sequence<I...>) {
+        bool ok = true;
+        const int decoded[] = {0, (ok = ok && decodeColumn(in, end, rows, get<I>(_columns)), 0)...};
+        static_cast<void>(decoded);
+        return ok;
+    }
+
+    template<typename Value>
+    static bool decodeColumn(const unsigned char*& in, const unsigned char* end, std::size_t rows,
+                             std::vector<Value>& column) {
+        std::uint64_t bytes;
+        if (!Tuple_Traits::getVarint(in, end, bytes) || bytes > static_cast<std::uint64_t>(end - in)) {
+            return false;
+        }
+        const unsigned char* columnEnd = in + bytes;
+        column.resize(rows);
+        const bool ok = Tuple_Traits::ColumnCodec<Value>::decode(in, columnEnd, column) && in == columnEnd;
+        in = columnEnd;
+        return ok;
+    }
+
+    bool loadBlock(std::size_t number) {
+        _block = number;
+        _row = 0;
+        _blockRows = 0;
+        _loaded = false;
+        const Tuple_Traits::CodecBlock& block = _blocks[number];
+        const std::uint64_t blockEnd = number + 1 < _blocks.size() ? _blocks[number + 1].offset : _blocksEnd;
+        if (blockEnd < block.offset || blockEnd > _blocksEnd) {
+            return false;
+        }
+        const unsigned char* in = _data + block.offset;
+        const unsigned char* end = _data + blockEnd;
+        std::uint64_t rows;
+        if (!Tuple_Traits::getVarint(in, end, rows) || rows != block.rows ||
+            !decodeColumns(in, end, static_cast<std::size_t>(rows), std::index_sequence_for<T...>())) {
+            return false;
+        }
+        _blockRows = static_cast<std::size_t>(rows);
+        _loaded = true;
+        return true;
+    }
+
+    template<std::size_t... I>
+    void readRow(Row& row, std::index_sequence<I...>) {
+        const int assigned[] = {0, (get<I>(row) = get<I>(_columns)[_row], 0)...};
+        static_cast<void>(assigned);
+    }
+
+    const unsigned char* _data;
+    std::size_t _size;
+    bool _valid = false;
+    std::uint64_t _blocksEnd = 0;
+    std::vector<Tuple_Traits::CodecBlock> _blocks;
+    std::size_t _block = 0;
+    std::size_t _row = 0;
+    std::size_t _blockRows = 0;
+    bool _loaded = false;
+    Tuple<std::vector<T>...> _columns;
+};
+
+#endif //TUPLE_TUPLE_CODEC_H
@@ -0,0 +1,431 @@
+#ifndef TUPLE_TUPLE_DICT_H
+#define TUPLE_TUPLE_DICT_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+#include "tuple_hash.h"
+
+// Dictionary encoding of low-cardinality string columns (country, status, tenant): every distinct
+// string is kept once in a StringDictionary and rows hold a 32-bit code into it. DictString is
+// the element type for such a column, in a Tuple or in TupleColumns, which stores the column as
+// bare codes. Codes of one dictionary are equal exactly when their strings are, so equality and
+// hashing never touch the strings; ordering does only while the dictionary is unsorted.
+
+namespace Tuple_Traits {
+    // the heap block a value owns: for a string, its capacity and terminator once it no longer
+    // fits the small-string buffer inside the object, nothing for other values
+    template<typename T>
+    std::size_t heapBlockBytes(const T&) {
+        return 0;
+    }
+
+    inline std::size_t heapBlockBytes(const std::string& value) {
+        return value.capacity() > std::string().capacity() ? value.capacity() + 1 : 0;
+    }
+}
+
+// Distinct strings numbered in insertion order. The dictionary stays sorted, codes in string
+// order, as long as the strings arrive ascending; sort() restores that at the price of new codes.
+class StringDictionary {
+public:
+    using Code = std::uint32_t;
+
+    // the code of the value, added if missing
+    Code encode(const std::string& value) {
+        const std::size_t hash = std::hash<std::string>()(value);
+        const std::size_t slot = slotOf(value, hash);
+        if (_index.holds(slot)) {
+            return static_cast<Code>(_index.position(slot));
+        }
+        assert(_values.size() < std::numeric_limits<Code>::max());
+        _sorted = _sorted && (_values.empty() || _values.back() < value);
+        _values.push_back(value);
+        _hashes.push_back(hash);
+        _index.place(slot, _values.size() - 1);
+        if (_index.crowded(_values.size())) {
+            rebuildIndex(2 * _index.slots());
+        }
+        return static_cast<Code>(_values.size() - 1);
+    }
+
+    // false if the value is not in the dictionary, so no row holds it
+    bool find(const std::string& value, Code& code) const {
+        const std::size_t slot = slotOf(value, std::hash<std::string>()(value));
+        if (!_index.holds(slot)) {
+            return false;
+        }
+        code = static_cast<Code>(_index.position(slot));
+        return true;
+    }
+
+    // first code whose string is not less than the value, size() if none; the dictionary must be
+    // sorted. Turns a range of strings into a range of codes for scans.
+    Code lowerBound(const std::string& value) const {
+        assert(_sorted);
+        return static_cast<Code>(std::lower_bound(_values.begin(), _values.end(), value) - _values.begin());
+    }
+
+    const std::string& operator[](Code code) const {
+        assert(code < _values.size());
+        return _values[code];
+    }
+
+    std::size_t size() const {
+        return _values.size();
+    }
+
+    bool sorted() const {
+        return _sorted;
+    }
+
+    // renumbers the strings in order and returns the new code of every old one; all codes held
+    // elsewhere must be mapped through it
+    std::vector<Code> sort() {
+        std::vector<Code> order(_values.size());
+        for (Code code = 0; code < order.size(); ++code) {
+            order[code] = code;
+        }
+        std::sort(order.begin(), order.end(), [this](Code left, Code right) {
+            return _values[left] < _values[right];
+        });
+        std::vector<Code> remap(order.size());
+        std::vector<std::string> values(order.size());
+        std::vector<std::size_t> hashes(order.size());
+        for (Code code = 0; code < order.size(); ++code) {
+            remap[order[code]] = code;
+            values[code] = std::move(_values[order[code]]);
+            hashes[code] = _hashes[order[code]];
+        }
+        _values.swap(values);
+        _hashes.swap(hashes);
+        rebuildIndex(_index.slots());
+        _sorted = true;
+        return remap;
+    }
+
+    // memory held, with the heap block of every string
+    std::size_t byteSize() const {
+        std::size_t bytes = sizeof(*this) + _values.capacity() * sizeof(std::string) +
+                            _hashes.capacity() * sizeof(std::size_t) + _index.byteSize();
+        for (const std::string& value : _values) {
+            bytes += Tuple_Traits::heapBlockBytes(value);
+        }
+        return bytes;
+    }
+
+private:
+    // the slot of the value's code, or the empty slot where it goes
+    std::size_t slotOf(const std::string& value, std::size_t hash) const {
+        return _index.find(hash, [&](std::size_t code) {
+            return _hashes[code] == hash && _values[code] == value;
+        });
+    }
+
+    // the index of codes doubles at half load
+    void rebuildIndex(std::size_t slots) {
+        _index.rebuild(slots, _values.size(), [this](std::size_t code) {
+            return _hashes[code];
+        });
+    }
+
+    std::vector<std::string> _values;
+    std::vector<std::size_t> _hashes;
+    Tuple_Traits::ProbeIndex<Code> _index;
+    bool _sorted = true;
+};
+
+// A string of a dictionary, held as its code: 16 bytes with no heap block, where a std::string
+// takes 32 plus one for anything longer than 15 characters. The dictionary must outlive it.
+// Values are compared only with values of the same dictionary, like iterators of one container.
+class DictString {
+public:
+    using Code = StringDictionary::Code;
+
+    DictString() = default;
+
+    DictString(const StringDictionary& dictionary, Code code) : _dictionary(&dictionary), _code(code) {
+    }
+
+    // a default-constructed value has no dictionary and no string
+    const std::string& str() const {
+        assert(_dictionary != nullptr);
+        return (*_dictionary)[_code];
+    }
+
+    Code code() const {
+        return _code;
+    }
+
+    const StringDictionary* dictionary() const {
+        return _dictionary;
+    }
+
+    friend bool operator==(const DictString& left, const DictString& right) {
+        assert(left._dictionary == right._dictionary);
+        return left._code == right._code;
+    }
+
+    // on the codes alone when the dictionary is sorted
+    friend bool operator<(const DictString& left, const DictString& right) {
+        assert(left._dictionary == right._dictionary && left._dictionary != nullptr);
+        return left._dictionary->sorted() ? left._code < right._code : left.str() < right.str();
+    }
+
+    friend bool operator==(const DictString& left, const std::string& right) {
+        return left.str() == right;
+    }
+
+    friend bool operator==(const std::string& left, const DictString& right) {
+        return left == right.str();
+    }
+
+    friend bool operator<(const DictString& left, const std::string& right) {
+        return left.str() < right;
+    }
+
+    friend bool operator<(const std::string& left, const DictString& right) {
+        return left < right.str();
+    }
+
+    template<typename Other>
+    friend bool operator!=(const DictString& left, const Other& right) {
+        return !(left == right);
+    }
+
+    template<typename Other>
+    friend bool operator>(const DictString& left, const Other& right) {
+        return right < left;
+    }
+
+    template<typename Other>
+    friend bool operator<=(const DictString& left, const Other& right) {
+        return !(right < left);
+    }
+
+    template<typename Other>
+    friend bool operator>=(const DictString& left, const Other& right) {
+        return !(left < right);
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const DictString& value) {
+        return out << value.str();
+    }
+
+private:
+    const StringDictionary* _dictionary = nullptr;
+    Code _code = 0;
+};
+
+// The code is the hash, mixed by TupleHash like any integer. Hashes are comparable only between
+// values of one dictionary: the same string has unrelated codes in two dictionaries, so a hash
+// table or filter must not mix keys from both.
+namespace std {
+    template<>
+    struct hash<DictString> {
+        std::size_t operator()(const DictString& value) const {
+            return value.code();
+        }
+    };
+}
+
+namespace Tuple_Traits {
+    // storage of one column of TupleColumns: the values themselves, or for DictString the codes
+    // and the dictionary they index
+    template<typename T>
+    struct DictColumn {
+        using Storage = T;
+        struct Dictionary {
+        };
+
+        template<typename V>
+        static void push(std::vector<T>& column, Dictionary&, V&& value) {
+            column.push_back(std::forward<V>(value));
+        }
+
+        static const T& value(const std::vector<T>& column, const Dictionary&, std::size_t i) {
+            return column[i];
+        }
+
+        // with the heap blocks the values own outside the column
+        static std::size_t bytes(const std::vector<T>& column, const Dictionary&) {
+            std::size_t bytes = column.capacity() * sizeof(T);
+            for (const T& value : column) {
+                bytes += heapBlockBytes(value);
+            }
+            return bytes;
+        }
+    };
+
+    template<>
+    struct DictColumn<DictString> {
+        using Storage = StringDictionary::Code;
+        using Dictionary = std::shared_ptr<StringDictionary>;
+
+        static void push(std::vector<Storage>& column, Dictionary& dictionary, const std::string& value) {
+            column.push_back(dictionary->encode(value));
+        }
+
+        static void push(std::vector<Storage>& column, Dictionary& dictionary, const DictString& value) {
+            assert(value.dictionary() != nullptr && "TupleColumns: a default-constructed DictString has no string");
+            column.push_back(value.dictionary() == dictionary.get() ? value.code() : dictionary->encode(value.str()));
+        }
+
+        static DictString value(const std::vector<Storage>& column, const Dictionary& dictionary, std::size_t i) {
+            return DictString(*dictionary, column[i]);
+        }
+
+        // the dictionary is counted by its owners
+        static std::size_t bytes(const std::vector<Storage>& column, const Dictionary&) {
+            return column.capacity() * sizeof(Storage);
+        }
+    };
+}
+
+template<typename Row>
+class TupleColumns;
+
+// Rows stored column by column, one std::vector per element; DictString columns hold 4-byte codes
+// into a dictionary of their own, or one shared with other columns and tables through
+// setDictionary. Rows are pushed as tuples of the element values, with std::string or DictString
+// for a DictString column, and read back by value with DictStrings of the column's dictionary.
+template<typename... T>
+class TupleColumns<Tuple<T...>> {
+public:
+    using Row = Tuple<T...>;
+
+    TupleColumns() {
+        makeDictionaries(std::index_sequence_for<T...>());
+    }
+
+    template<typename... V>
+    void push_back(const Tuple<V...>& row) {
+        static_assert(sizeof...(V) == sizeof...(T), "TupleColumns: row of another width");
+        pushColumns(row, std::index_sequence_for<T...>());
+        ++_size;
+    }
+
+    Row operator[](std::size_t i) const {
+        assert(i < _size);
+        return row(i, std::index_sequence_for<T...>());
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    void reserve(std::size_t rows) {
+        reserveColumns(rows, std::index_sequence_for<T...>());
+    }
+
+    // the values of column N, the codes for a DictString column
+    template<int N>
+    const std::vector<typename Tuple_Traits::DictColumn<Tuple_Traits::tuple_element_t<N, Row>>::Storage>& column() const {
+        return get<N>(_columns);
+    }
+
+    template<int N>
+    const StringDictionary& dictionary() const {
+        return *get<N>(_dictionaries);
+    }
+
+    // column N encodes into `dictionary` from now on, e.g. one dictionary for the tables that
+    // are joined on the column; only while the table is empty
+    template<int N>
+    void setDictionary(std::shared_ptr<StringDictionary> dictionary) {
+        assert(_size == 0 && dictionary);
+        get<N>(_dictionaries) = std::move(dictionary);
+    }
+
+    // sorts the dictionary of column N and re-encodes the column, so ordering compares codes;
+    // the dictionary must not be shared, or the codes of its other users would go stale
+    template<int N>
+    void sortDictionary() {
+        assert(get<N>(_dictionaries).use_count() == 1);
+        const std::vector<StringDictionary::Code> remap = get<N>(_dictionaries)->sort();
+        for (StringDictionary::Code& code : get<N>(_columns)) {
+            code = remap[code];
+        }
+    }
+
+    // bytes of the columns and of the dictionaries they use, each dictionary counted once
+    std::size_t byteSize() const {
+        std::vector<const StringDictionary*> counted;
+        return byteSize(counted, std::index_sequence_for<T...>());
+    }
+
+private:
+    template<std::size_t I>
+    using Column = Tuple_Traits::DictColumn<Tuple_Traits::tuple_element_t<I, Row>>;
+
+    template<std::size_t... I>
+    void makeDictionaries(std::index_sequence<I...>) {
+        const int made[] = {0, (makeDictionary(get<I>(_dictionaries)), 0)...};
+        static_cast<void>(made);
+    }
+
+    static void makeDictionary(std::shared_ptr<StringDictionary>& dictionary) {
+        dictionary = std::make_shared<StringDictionary>();
+    }
+
+    template<typename Dictionary>
+    static void makeDictionary(Dictionary&) {
+    }
+
+    template<typename Source, std::size_t... I>
+    void pushColumns(const Source& row, std::index_sequence<I...>) {
+        const int pushed[] = {0, (Column<I>::push(get<I>(_columns), get<I>(_dictionaries), get<I>(row)), 0)...};
+        static_cast<void>(pushed);
+    }
+
+    template<std::size_t... I>
+    Row row(std::size_t i, std::index_sequence<I...>) const {
+        return Row(Column<I>::value(get<I>(_columns), get<I>(_dictionaries), i)...);
+    }
+
+    template<std::size_t... I>
+    void reserveColumns(std::size_t rows, std::index_sequence<I...>) {
+        const int reserved[] = {0, (get<I>(_columns).reserve(rows), 0)...};
+        static_cast<void>(reserved);
+    }
+
+    static std::size_t dictionaryBytes(const std::shared_ptr<StringDictionary>& dictionary,
+                                       std::vector<const StringDictionary*>& counted) {
+        if (std::find(counted.begin(), counted.end(), dictionary.get()) != counted.end()) {
+            return 0;
+        }
+        counted.push_back(dictionary.get());
+        return dictionary->byteSize();
+    }
+
+    template<typename Dictionary>
+    static std::size_t dictionaryBytes(const Dictionary&, std::vector<const StringDictionary*>&) {
+        return 0;
+    }
+
+    template<std::size_t... I>
+    std::size_t byteSize(std::vector<const StringDictionary*>& counted, std::index_sequence<I...>) const {
+        std::size_t bytes = sizeof(*this);
+        const int added[] = {0, (bytes += Column<I>::bytes(get<I>(_columns), get<I>(_dictionaries)) +
+                                          dictionaryBytes(get<I>(_dictionaries), counted), 0)...};
+        static_cast<void>(added);
+        return bytes;
+    }
+
+    Tuple<std::vector<typename Tuple_Traits::DictColumn<T>::Storage>...> _columns;
+    Tuple<typename Tuple_Traits::DictColumn<T>::Dictionary...> _dictionaries;
+    std::size_t _size = 0;
+};
+
+#endif //TUPLE_TUPLE_DICT_H
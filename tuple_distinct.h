@@ -0,0 +1,123 @@
+#ifndef TUPLE_TUPLE_DISTINCT_H
+#define TUPLE_TUPLE_DISTINCT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+#include "tuple_hash.h"
+#include "tuple_join.h"
+
+namespace Tuple_Traits {
+    // Set of rows seen so far: row pointers with their hashes, found through a ProbeIndex that
+    // doubles at half load, so with many duplicates it stays as small as the distinct rows. Equal
+    // rows are found by comparing the elements in place, no element is copied.
+    template<typename Row>
+    class DistinctTable {
+    public:
+        // false if an equal row is already in the table, the row must stay where it is
+        bool insert(const Row& row, std::size_t hash) {
+            const std::size_t slot = _index.find(hash, [&](std::size_t position) {
+                const HashedRow<Row>& seen = _rows[position];
+                return seen.hash == hash && columnsEqual(*seen.row, row, all_columns_t<Row>(), all_columns_t<Row>());
+            });
+            if (_index.holds(slot)) {
+                return false;
+            }
+            _rows.push_back({&row, hash});
+            _index.place(slot, _rows.size() - 1);
+            if (_index.crowded(_rows.size())) {
+                _index.rebuild(2 * _index.slots(), _rows.size(), [this](std::size_t position) {
+                    return _rows[position].hash;
+                });
+            }
+            return true;
+        }
+
+    private:
+        std::vector<HashedRow<Row>> _rows;
+        ProbeIndex<> _index;
+    };
+}
+
+// removes duplicate rows in place: a duplicate is overwritten by the last row, so rows are moved,
+// never copied, and the survivors are left in no particular order
+template<typename... T>
+void distinct(std::vector<Tuple<T...>>& rows) {
+    using Row = Tuple<T...>;
+    Tuple_Traits::DistinctTable<Row> table;
+    std::size_t i = 0;
+    while (i < rows.size()) {
+        if (table.insert(rows[i], TupleHash()(rows[i]))) {
+            ++i;
+        } else {
+            if (i + 1 < rows.size()) {
+                rows[i] = std::move(rows.back());
+            }
+            rows.pop_back();
+        }
+    }
+}
+
+// rows without duplicates, the first of every group of equal rows in input order
+template<typename... T>
+std::vector<Tuple<T...>> distinctStable(const std::vector<Tuple<T...>>& rows) {
+    using Row = Tuple<T...>;
+    Tuple_Traits::DistinctTable<Row> table;
+    std::vector<Row> result;
+    for (const Row& row : rows) {
+        if (table.insert(row, TupleHash()(row))) {
+            result.push_back(row);
+        }
+    }
+    return result;
+}
+
+// distinctStable on `threads` threads: the rows are hashed in parallel, then every thread scans
+// them in order and keeps the ones whose top hash bits select it. Equal rows select the same
+// thread, so the threads need no common table. Rows come out grouped by thread, each group in
+// input order.
+template<typename... T>
+std::vector<Tuple<T...>> distinctParallel(const std::vector<Tuple<T...>>& rows,
+                                          unsigned threads = std::thread::hardware_concurrency()) {
+    using Row = Tuple<T...>;
+    threads = std::max(1u, threads);
+    const std::size_t count = rows.size();
+    std::vector<std::size_t> hashes(count);
+    std::vector<std::vector<Row>> parts(threads);
+    const auto run = [threads](auto work) {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back(work, t);
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    };
+    run([&](unsigned t) {
+        for (std::size_t i = count * t / threads; i < count * (t + 1) / threads; ++i) {
+            hashes[i] = TupleHash()(rows[i]);
+        }
+    });
+    run([&](unsigned t) {
+        // the table probes with the low bits, the owner is picked with the high ones
+        constexpr unsigned shift = std::numeric_limits<std::size_t>::digits / 2;
+        Tuple_Traits::DistinctTable<Row> table;
+        for (std::size_t i = 0; i < count; ++i) {
+            if ((hashes[i] >> shift) % threads == t && table.insert(rows[i], hashes[i])) {
+                parts[t].push_back(rows[i]);
+            }
+        }
+    });
+    std::vector<Row> result = std::move(parts[0]);
+    for (unsigned t = 1; t < threads; ++t) {
+        result.insert(result.end(), std::make_move_iterator(parts[t].begin()), std::make_move_iterator(parts[t].end()));
+    }
+    return result;
+}
+
+#endif //TUPLE_TUPLE_DISTINCT_H
@@ -0,0 +1,277 @@
+#ifndef TUPLE_TUPLE_HASH_H
+#define TUPLE_TUPLE_HASH_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+
+// list of column positions, e.g. Columns<0, 2>
+template<int... I>
+struct Columns {
+    constexpr static std::size_t size() {
+        return sizeof...(I);
+    }
+};
+
+namespace Tuple_Traits {
+    template<typename Indices>
+    struct all_columns;
+
+    template<std::size_t... I>
+    struct all_columns<std::index_sequence<I...>> {
+        using type = Columns<static_cast<int>(I)...>;
+    };
+
+    // Columns<0, 1, ..., N - 1> of a Tuple
+    template<typename Row>
+    using all_columns_t = typename all_columns<std::make_index_sequence<Row::size()>>::type;
+
+    constexpr std::size_t hashCombine(std::size_t seed, std::size_t value) {
+        return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    // murmur3 finalizer: std::hash of integers is the identity, spread it over all bits
+    constexpr std::uint64_t mixHash(std::uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    template<typename T>
+    std::size_t hashValue(const T& value) {
+        return std::hash<std::decay_t<T>>()(value);
+    }
+
+    inline std::size_t hashElements(const Tuple<>&, std::size_t seed) {
+        return seed;
+    }
+
+    template<typename First, typename... T_other>
+    std::size_t hashElements(const Tuple<First, T_other...>& tuple, std::size_t seed) {
+        return hashElements(tuple.next(), hashCombine(seed, hashValue(tuple.get())));
+    }
+
+    template<typename Row>
+    std::size_t hashColumns(const Row&, Columns<>, std::size_t seed) {
+        return seed;
+    }
+
+    template<typename Row, int First, int... Other>
+    std::size_t hashColumns(const Row& row, Columns<First, Other...>, std::size_t seed) {
+        return hashColumns(row, Columns<Other...>(), hashCombine(seed, hashValue(get<First>(row))));
+    }
+
+    template<typename Left, typename Right>
+    constexpr bool columnsEqual(const Left&, const Right&, Columns<>, Columns<>) {
+        return true;
+    }
+
+    template<typename Left, typename Right, int L_first, int... L_other, int R_first, int... R_other>
+    constexpr bool columnsEqual(const Left& left, const Right& right,
+                                Columns<L_first, L_other...>, Columns<R_first, R_other...>) {
+        return get<L_first>(left) == get<R_first>(right) &&
+               columnsEqual(left, right, Columns<L_other...>(), Columns<R_other...>());
+    }
+
+    // Linear-probing index over an array the caller owns: every slot holds a position in that
+    // array + 1, 0 for an empty slot. The caller keeps the hash of every position and passes
+    // hashOf(position) where the index has to find the home slot of other positions. The number
+    // of slots is a power of two, doubled by the caller with rebuild() once crowded() holds.
+    template<typename Position = std::size_t>
+    class ProbeIndex {
+    public:
+        explicit ProbeIndex(std::size_t slots = 16) : _slots(slots, probeEmpty), _mask(slots - 1) {
+            assert(slots > 0 && (slots & _mask) == 0);
+        }
+
+        // the slot holding a position for which match(position) holds, otherwise the empty slot
+        // that ends the probe run, where place() puts a new position
+        template<typename Match>
+        std::size_t find(std::size_t hash, Match&& match) const {
+            std::size_t i = hash & _mask;
+            while (_slots[i] != probeEmpty && !match(static_cast<std::size_t>(_slots[i] - 1))) {
+                i = (i + 1) & _mask;
+            }
+            return i;
+        }
+
+        bool holds(std::size_t slot) const {
+            return _slots[slot] != probeEmpty;
+        }
+
+        std::size_t position(std::size_t slot) const {
+            return static_cast<std::size_t>(_slots[slot] - 1);
+        }
+
+        // also repoints a slot after its position moved in the caller's array
+        void place(std::size_t slot, std::size_t position) {
+            _slots[slot] = static_cast<Position>(position + 1);
+        }
+
+        void link(std::size_t hash, std::size_t position) {
+            std::size_t i = hash & _mask;
+            while (_slots[i] != probeEmpty) {
+                i = (i + 1) & _mask;
+            }
+            place(i, position);
+        }
+
+        std::size_t slotOf(std::size_t hash, std::size_t position) const {
+            std::size_t i = hash & _mask;
+            while (_slots[i] != static_cast<Position>(position + 1)) {
+                i = (i + 1) & _mask;
+            }
+            return i;
+        }
+
+        // backward shift: pull later members of the probe run into the hole, no tombstones
+        template<typename HashOf>
+        void unlink(std::size_t slot, HashOf&& hashOf) {
+            for (std::size_t next = (slot + 1) & _mask; _slots[next] != probeEmpty; next = (next + 1) & _mask) {
+                const std::size_t home = hashOf(position(next)) & _mask;
+                if (((next - home) & _mask) >= ((next - slot) & _mask)) {
+                    _slots[slot] = _slots[next];
+                    slot = next;
+                }
+            }
+            _slots[slot] = probeEmpty;
+        }
+
+        // more than half of the slots hold one of `count` positions
+        bool crowded(std::size_t count) const {
+            return 2 * count > _slots.size();
+        }
+
+        // `slots` slots holding positions 0 to count - 1
+        template<typename HashOf>
+        void rebuild(std::size_t slots, std::size_t count, HashOf&& hashOf) {
+            _slots.assign(slots, probeEmpty);
+            _mask = slots - 1;
+            for (std::size_t position = 0; position < count; ++position) {
+                link(hashOf(position), position);
+            }
+        }
+
+        void clear() {
+            _slots.assign(_slots.size(), probeEmpty);
+        }
+
+        std::size_t slots() const {
+            return _slots.size();
+        }
+
+        std::size_t byteSize() const {
+            return _slots.capacity() * sizeof(Position);
+        }
+
+    private:
+        constexpr static Position probeEmpty = 0;
+
+        std::vector<Position> _slots;
+        std::size_t _mask;
+    };
+
+    template<typename Position>
+    constexpr Position ProbeIndex<Position>::probeEmpty;
+
+    // One step of StableTupleHash. Words are derived from the values alone, never from their
+    // bytes in memory or from std::hash, so the hash is the same in every run and on every platform.
+    constexpr std::uint64_t stableStep(std::uint64_t h, std::uint64_t word) {
+        return mixHash((h + 0x9e3779b97f4a7c15ULL) ^ word);
+    }
+
+    template<typename T, typename = std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value>>
+    std::uint64_t stableHashValue(std::uint64_t h, T value) {
+        return stableStep(h, static_cast<std::uint64_t>(value));
+    }
+
+    // characters are bytes, as in the string path: plain char is signed on some targets and
+    // unsigned on others, so it is never sign-extended
+    inline std::uint64_t stableHashValue(std::uint64_t h, char value) {
+        return stableStep(h, static_cast<unsigned char>(value));
+    }
+
+    inline std::uint64_t stableHashValue(std::uint64_t h, signed char value) {
+        return stableStep(h, static_cast<unsigned char>(value));
+    }
+
+    // -0.0 hashes as 0.0, since the two compare equal
+    inline std::uint64_t stableHashValue(std::uint64_t h, double value) {
+        std::uint64_t bits;
+        value = value == 0.0 ? 0.0 : value;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return stableStep(h, bits);
+    }
+
+    inline std::uint64_t stableHashValue(std::uint64_t h, float value) {
+        std::uint32_t bits;
+        value = value == 0.0f ? 0.0f : value;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return stableStep(h, bits);
+    }
+
+    // 8 bytes at a time read as little endian, then the length
+    inline std::uint64_t stableHashValue(std::uint64_t h, const std::string& value) {
+        std::uint64_t word = 0;
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            word |= static_cast<std::uint64_t>(static_cast<unsigned char>(value[i])) << (8 * (i % 8));
+            if (i % 8 == 7) {
+                h = stableStep(h, word);
+                word = 0;
+            }
+        }
+        if (value.size() % 8 != 0) {
+            h = stableStep(h, word);
+        }
+        return stableStep(h, value.size());
+    }
+
+    inline std::uint64_t stableHashElements(const Tuple<>&, std::uint64_t h) {
+        return h;
+    }
+
+    template<typename First, typename... T_other>
+    std::uint64_t stableHashElements(const Tuple<First, T_other...>& tuple, std::uint64_t h) {
+        return stableHashElements(tuple.next(), stableHashValue(h, tuple.get()));
+    }
+}
+
+struct TupleHash {
+    template<typename... T>
+    std::size_t operator()(const Tuple<T...>& tuple) const {
+        return Tuple_Traits::mixHash(Tuple_Traits::hashElements(tuple, 0));
+    }
+};
+
+// 64-bit hash fixed by the element values, for hashes that are persisted, e.g. in the filters of
+// tuple_filter.h; integers, enums, floating point and std::string elements
+struct StableTupleHash {
+    template<typename... T>
+    std::uint64_t operator()(const Tuple<T...>& tuple, std::uint64_t seed = 0) const {
+        return Tuple_Traits::stableHashElements(tuple, seed);
+    }
+};
+
+// hash of the chosen columns only, equal to TupleHash of the projected tuple
+template<typename Keys, typename... T>
+std::size_t hashColumns(const Tuple<T...>& tuple) {
+    return Tuple_Traits::mixHash(Tuple_Traits::hashColumns(tuple, Keys(), 0));
+}
+
+namespace std {
+    template<typename... T>
+    struct hash<Tuple<T...>> : TupleHash {};
+}
+
+#endif //TUPLE_TUPLE_HASH_H
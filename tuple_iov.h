@@ -0,0 +1,384 @@
+#ifndef TUPLE_TUPLE_IOV_H
+#define TUPLE_TUPLE_IOV_H
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "tuple.h"
+
+// Rows written and read with writev / readv: elements of iovCopyBytes or more straight from and
+// into their own storage, shorter ones through one staging buffer. Elements go out in order:
+// trivially copyable ones as their bytes, std::string and std::vector of trivially copyable values
+// as their data. The lengths of those come first, as 8-byte counts in a small side buffer, so a
+// reader can size them before the single readv of the row:
+//
+//   row    lengths of the variable-size elements, then the elements
+//   batch  8-byte row count, the lengths of all its rows, then all their elements
+//
+// Everything is in the writer's native byte order and sizes, meant for pipes, sockets and files
+// between processes of one build; TupleEncoder is the portable format.
+
+namespace Tuple_Traits {
+    // rows per writev batch, bounding the iovec and length arrays
+    constexpr std::size_t iovBatchRows = 256;
+    // larger lengths read from a stream are taken as damage, not allocated
+    constexpr std::uint64_t iovMaxElementBytes = std::uint64_t(1) << 32;
+    // shorter elements are copied into one staging buffer, every iovec costs the kernel more than
+    // copying a few hundred bytes
+    constexpr std::size_t iovCopyBytes = 512;
+
+    template<typename T, typename = void>
+    struct iov_element {
+        static_assert(sizeof(T) == 0, "tuple_iov: element is neither trivially copyable nor a string or vector of them");
+    };
+
+    template<typename T>
+    struct iov_element<T, std::enable_if_t<std::is_trivially_copyable<T>::value>> {
+        constexpr static bool variable = false;
+
+        static std::uint64_t length(const T&) {
+            return 0;
+        }
+
+        static bool resize(T&, std::uint64_t) {
+            return true;
+        }
+
+        static void* data(const T& value) {
+            return const_cast<T*>(&value);
+        }
+
+        static std::size_t bytes(const T&) {
+            return sizeof(T);
+        }
+    };
+
+    template<>
+    struct iov_element<std::string> {
+        constexpr static bool variable = true;
+
+        static std::uint64_t length(const std::string& value) {
+            return value.size();
+        }
+
+        static bool resize(std::string& value, std::uint64_t length) {
+            if (length > iovMaxElementBytes) {
+                return false;
+            }
+            value.resize(static_cast<std::size_t>(length));
+            return true;
+        }
+
+        static void* data(const std::string& value) {
+            return const_cast<char*>(value.data());
+        }
+
+        static std::size_t bytes(const std::string& value) {
+            return value.size();
+        }
+    };
+
+    template<typename U, typename A>
+    struct iov_element<std::vector<U, A>, std::enable_if_t<std::is_trivially_copyable<U>::value && !std::is_same<U, bool>::value>> {
+        constexpr static bool variable = true;
+
+        static std::uint64_t length(const std::vector<U, A>& value) {
+            return value.size();
+        }
+
+        static bool resize(std::vector<U, A>& value, std::uint64_t length) {
+            if (length > iovMaxElementBytes / sizeof(U)) {
+                return false;
+            }
+            value.resize(static_cast<std::size_t>(length));
+            return true;
+        }
+
+        static void* data(const std::vector<U, A>& value) {
+            return const_cast<U*>(value.data());
+        }
+
+        static std::size_t bytes(const std::vector<U, A>& value) {
+            return value.size() * sizeof(U);
+        }
+    };
+
+    template<typename T>
+    using iov_element_t = iov_element<std::decay_t<T>>;
+
+    template<typename... T>
+    constexpr std::size_t iovVariableCount(const Tuple<T...>*) {
+        std::size_t count = 0;
+        const bool variable[] = {false, iov_element<std::decay_t<T>>::variable...};
+        for (const bool v : variable) {
+            count += v;
+        }
+        return count;
+    }
+
+    // number of variable-size elements of a row type, each one length in the side buffer
+    template<typename Row>
+    constexpr std::size_t iov_lengths = iovVariableCount(static_cast<const Row*>(nullptr));
+
+    // Elements of rows as iovecs for one direction. Elements shorter than iovCopyBytes are
+    // staged: copied into one buffer as they are added to be written, or read into it and copied
+    // out by finishRead. Every run of them takes one iovec, as do longer elements and runs of
+    // adjacent ones.
+    class IovList {
+    public:
+        explicit IovList(bool write) : _write(write) {
+        }
+
+        void add(void* data, std::size_t bytes) {
+            if (bytes == 0) {
+                return;
+            }
+            if (bytes < iovCopyBytes) {
+                const std::size_t offset = _staging.size();
+                if (_write) {
+                    _staging.insert(_staging.end(), static_cast<char*>(data), static_cast<char*>(data) + bytes);
+                } else {
+                    _staging.resize(offset + bytes);
+                    _copies.push_back({static_cast<char*>(data), bytes});
+                }
+                if (_lastStaged) {
+                    _iov.back().iov_len += bytes;
+                } else {
+                    _iov.push_back({nullptr, bytes});
+                    _runs.push_back({_iov.size() - 1, offset});
+                    _lastStaged = true;
+                }
+                return;
+            }
+            if (!_lastStaged && !_iov.empty() && static_cast<char*>(_iov.back().iov_base) + _iov.back().iov_len == data) {
+                _iov.back().iov_len += bytes;
+            } else {
+                _iov.push_back({data, bytes});
+            }
+            _lastStaged = false;
+        }
+
+        template<typename Row, std::size_t... I>
+        void addElements(const Row& row, std::index_sequence<I...>) {
+            const int added[] = {0, (add(iov_element_t<decltype(get<I>(row))>::data(get<I>(row)),
+                                         iov_element_t<decltype(get<I>(row))>::bytes(get<I>(row))), 0)...};
+            static_cast<void>(added);
+        }
+
+        // the iovecs, once everything is added; the staging buffer no longer moves
+        iovec* prepare() {
+            for (const Run& run : _runs) {
+                _iov[run.iov].iov_base = _staging.data() + run.offset;
+            }
+            return _iov.data();
+        }
+
+        std::size_t size() const {
+            return _iov.size();
+        }
+
+        // copies the staged bytes of a completed read to the elements
+        void finishRead() const {
+            const char* staged = _staging.data();
+            for (const Copy& copy : _copies) {
+                std::memcpy(copy.data, staged, copy.bytes);
+                staged += copy.bytes;
+            }
+        }
+
+        void clear() {
+            _iov.clear();
+            _runs.clear();
+            _copies.clear();
+            _staging.clear();
+            _lastStaged = false;
+        }
+
+    private:
+        struct Run {
+            std::size_t iov;
+            std::size_t offset;
+        };
+
+        struct Copy {
+            char* data;
+            std::size_t bytes;
+        };
+
+        std::vector<iovec> _iov;
+        std::vector<Run> _runs;
+        std::vector<Copy> _copies;
+        std::vector<char> _staging;
+        bool _write;
+        bool _lastStaged = false;
+    };
+
+    template<typename Row, std::size_t... I>
+    void appendLengths(const Row& row, std::vector<std::uint64_t>& lengths, std::index_sequence<I...>) {
+        const int appended[] = {0, (iov_element_t<decltype(get<I>(row))>::variable
+                                    ? (lengths.push_back(iov_element_t<decltype(get<I>(row))>::length(get<I>(row))), 0)
+                                    : 0)...};
+        static_cast<void>(appended);
+    }
+
+    // sizes the variable elements from the lengths read, false on a damaged length
+    template<typename Row, std::size_t... I>
+    bool applyLengths(Row& row, const std::uint64_t*& lengths, std::index_sequence<I...>) {
+        bool ok = true;
+        const int applied[] = {0, (ok = ok && (!iov_element_t<decltype(get<I>(row))>::variable ||
+                                               iov_element_t<decltype(get<I>(row))>::resize(get<I>(row), *lengths++)), 0)...};
+        static_cast<void>(applied);
+        return ok;
+    }
+
+    // writev / readv of all the iovecs, IOV_MAX at a time, resuming after short transfers and
+    // EINTR; false on an error, or on end of file before everything was read
+    inline bool transferAll(int fd, iovec* iov, std::size_t count, bool write) {
+        while (count > 0) {
+            const int chunk = static_cast<int>(std::min<std::size_t>(count, IOV_MAX));
+            const ssize_t done = write ? ::writev(fd, iov, chunk) : ::readv(fd, iov, chunk);
+            if (done < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (done == 0 && !write) {
+                return false;
+            }
+            std::size_t left = static_cast<std::size_t>(done);
+            while (count > 0 && left >= iov->iov_len) {
+                left -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (left > 0) {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+        return true;
+    }
+
+    inline bool transferAll(int fd, void* data, std::size_t bytes, bool write) {
+        iovec iov = {data, bytes};
+        return bytes == 0 || transferAll(fd, &iov, 1, write);
+    }
+}
+
+template<typename... T>
+bool writeTuple(int fd, const Tuple<T...>& row) {
+    std::vector<std::uint64_t> lengths;
+    Tuple_Traits::appendLengths(row, lengths, std::index_sequence_for<T...>());
+    Tuple_Traits::IovList iov(true);
+    iov.add(lengths.data(), lengths.size() * sizeof(std::uint64_t));
+    iov.addElements(row, std::index_sequence_for<T...>());
+    iovec* vectors = iov.prepare();
+    return Tuple_Traits::transferAll(fd, vectors, iov.size(), true);
+}
+
+// reads a row written by writeTuple; on false the row is partly overwritten
+template<typename... T>
+bool readTuple(int fd, Tuple<T...>& row) {
+    std::uint64_t lengths[Tuple_Traits::iov_lengths<Tuple<T...>> + 1];
+    if (!Tuple_Traits::transferAll(fd, lengths, Tuple_Traits::iov_lengths<Tuple<T...>> * sizeof(std::uint64_t), false)) {
+        return false;
+    }
+    const std::uint64_t* next = lengths;
+    if (!Tuple_Traits::applyLengths(row, next, std::index_sequence_for<T...>())) {
+        return false;
+    }
+    Tuple_Traits::IovList iov(false);
+    iov.addElements(row, std::index_sequence_for<T...>());
+    iovec* vectors = iov.prepare();
+    if (!Tuple_Traits::transferAll(fd, vectors, iov.size(), false)) {
+        return false;
+    }
+    iov.finishRead();
+    return true;
+}
+
+// writes the rows as batches of up to iovBatchRows, one writev per batch unless the pipe or
+// socket takes less at a time
+template<typename InputIt>
+bool writeTuples(int fd, InputIt first, InputIt last) {
+    using Row = typename std::iterator_traits<InputIt>::value_type;
+    using Indices = std::make_index_sequence<Row::size()>;
+    std::vector<std::uint64_t> header;
+    std::vector<const Row*> batch;
+    Tuple_Traits::IovList iov(true);
+    while (first != last) {
+        batch.clear();
+        for (; first != last && batch.size() < Tuple_Traits::iovBatchRows; ++first) {
+            batch.push_back(&*first);
+        }
+        header.assign(1, batch.size());
+        for (const Row* row : batch) {
+            Tuple_Traits::appendLengths(*row, header, Indices());
+        }
+        iov.clear();
+        iov.add(header.data(), header.size() * sizeof(std::uint64_t));
+        for (const Row* row : batch) {
+            iov.addElements(*row, Indices());
+        }
+        iovec* vectors = iov.prepare();
+        if (!Tuple_Traits::transferAll(fd, vectors, iov.size(), true)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Rows>
+bool writeTuples(int fd, const Rows& rows) {
+    return writeTuples(fd, std::begin(rows), std::end(rows));
+}
+
+// reads one batch written by writeTuples and appends its rows; false at end of file or on an
+// error. A reader that knows the row count calls it until it has them all.
+template<typename... T>
+bool readTuples(int fd, std::vector<Tuple<T...>>& rows) {
+    using Row = Tuple<T...>;
+    using Indices = std::index_sequence_for<T...>;
+    constexpr std::size_t lengthCount = Tuple_Traits::iov_lengths<Row>;
+    std::uint64_t count;
+    if (!Tuple_Traits::transferAll(fd, &count, sizeof(count), false) || count > Tuple_Traits::iovBatchRows) {
+        return false;
+    }
+    std::vector<std::uint64_t> lengths(static_cast<std::size_t>(count) * lengthCount);
+    if (!Tuple_Traits::transferAll(fd, lengths.data(), lengths.size() * sizeof(std::uint64_t), false)) {
+        return false;
+    }
+    const std::size_t first = rows.size();
+    rows.resize(first + static_cast<std::size_t>(count));
+    const std::uint64_t* next = lengths.data();
+    Tuple_Traits::IovList iov(false);
+    for (std::size_t i = first; i < rows.size(); ++i) {
+        if (!Tuple_Traits::applyLengths(rows[i], next, Indices())) {
+            rows.resize(first);
+            return false;
+        }
+        iov.addElements(rows[i], Indices());
+    }
+    iovec* vectors = iov.prepare();
+    if (!Tuple_Traits::transferAll(fd, vectors, iov.size(), false)) {
+        rows.resize(first);
+        return false;
+    }
+    iov.finishRead();
+    return true;
+}
+
+#endif //TUPLE_TUPLE_IOV_H
@@ -0,0 +1,198 @@
+#ifndef TUPLE_TUPLE_JOIN_H
+#define TUPLE_TUPLE_JOIN_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+#include "tuple_hash.h"
+
+namespace Tuple_Traits {
+    constexpr std::size_t joinChainEnd = std::numeric_limits<std::size_t>::max();
+
+    // chained hash table over rows of the build side, rows are not copied
+    template<typename Row, typename Keys>
+    class JoinTable {
+    public:
+        explicit JoinTable(std::size_t capacity) : _mask(bucketCount(capacity) - 1),
+                                                   _heads(bucketCount(capacity), joinChainEnd) {
+            _rows.reserve(capacity);
+            _hashes.reserve(capacity);
+            _next.reserve(capacity);
+        }
+
+        void insert(const Row& row, std::size_t hash) {
+            std::size_t& head = _heads[hash & _mask];
+            _rows.push_back(&row);
+            _hashes.push_back(hash);
+            _next.push_back(head);
+            head = _rows.size() - 1;
+        }
+
+        template<typename ProbeKeys, typename Probe, typename F>
+        void probe(const Probe& row, std::size_t hash, F&& f) const {
+            for (std::size_t i = _heads[hash & _mask]; i != joinChainEnd; i = _next[i]) {
+                if (_hashes[i] == hash && columnsEqual(*_rows[i], row, Keys(), ProbeKeys())) {
+                    f(*_rows[i]);
+                }
+            }
+        }
+
+    private:
+        static std::size_t bucketCount(std::size_t capacity) {
+            std::size_t count = 1;
+            while (count < 2 * capacity) {
+                count <<= 1;
+            }
+            return count;
+        }
+
+        std::size_t _mask;
+        std::vector<std::size_t> _heads;
+        std::vector<const Row*> _rows;
+        std::vector<std::size_t> _hashes;
+        std::vector<std::size_t> _next;
+    };
+
+    template<typename Row>
+    struct HashedRow {
+        const Row* row;
+        std::size_t hash;
+    };
+
+    // builds on `build`, probes with `probe`; emit(buildRow, probeRow)
+    template<typename BuildKeys, typename ProbeKeys, typename Build, typename Probe, typename Emit>
+    void joinPartition(const HashedRow<Build>* build, std::size_t buildSize,
+                       const HashedRow<Probe>* probe, std::size_t probeSize, Emit&& emit) {
+        JoinTable<Build, BuildKeys> table(buildSize);
+        for (std::size_t i = 0; i < buildSize; ++i) {
+            table.insert(*build[i].row, build[i].hash);
+        }
+        for (std::size_t i = 0; i < probeSize; ++i) {
+            const Probe& row = *probe[i].row;
+            table.template probe<ProbeKeys>(row, probe[i].hash, [&](const Build& match) {
+                emit(match, row);
+            });
+        }
+    }
+
+    template<typename Keys, typename Row>
+    std::vector<HashedRow<Row>> hashRows(const std::vector<Row>& rows) {
+        std::vector<HashedRow<Row>> result;
+        result.reserve(rows.size());
+        for (const Row& row : rows) {
+            result.push_back({&row, hashColumns<Keys>(row)});
+        }
+        return result;
+    }
+
+    // stable scatter of rows by the top `bits` of their hash, bounds has 2^bits + 1 entries
+    template<typename Row>
+    std::vector<HashedRow<Row>> partitionRows(const std::vector<HashedRow<Row>>& rows, unsigned bits,
+                                              std::vector<std::size_t>& bounds) {
+        const unsigned shift = std::numeric_limits<std::size_t>::digits - bits;
+        bounds.assign((std::size_t(1) << bits) + 1, 0);
+        for (const HashedRow<Row>& row : rows) {
+            ++bounds[(row.hash >> shift) + 1];
+        }
+        for (std::size_t i = 1; i < bounds.size(); ++i) {
+            bounds[i] += bounds[i - 1];
+        }
+        std::vector<std::size_t> offsets(bounds.begin(), bounds.end() - 1);
+        std::vector<HashedRow<Row>> result(rows.size());
+        for (const HashedRow<Row>& row : rows) {
+            result[offsets[row.hash >> shift]++] = row;
+        }
+        return result;
+    }
+
+    template<typename Left, typename Right>
+    using join_result_t = decltype(tupleCat(std::declval<const Left&>(), std::declval<const Right&>()));
+
+    constexpr std::size_t joinPartitionRows = 4096;
+    constexpr unsigned joinMaxRadixBits = 12;
+}
+
+// inner equi-join on left columns LeftKeys == right columns RightKeys, e.g.
+// hashJoin<Columns<0>, Columns<1>>(left, right); rows are tupleCat(leftRow, rightRow).
+// The hash table is built on the smaller input.
+template<typename LeftKeys, typename RightKeys, typename... L, typename... R>
+std::vector<Tuple_Traits::join_result_t<Tuple<L...>, Tuple<R...>>> hashJoin(const std::vector<Tuple<L...>>& left,
+                                                                             const std::vector<Tuple<R...>>& right) {
+    static_assert(LeftKeys::size() == RightKeys::size(), "hashJoin: key column counts differ");
+    using Left = Tuple<L...>;
+    using Right = Tuple<R...>;
+
+    std::vector<Tuple_Traits::join_result_t<Left, Right>> result;
+    const auto leftRows = Tuple_Traits::hashRows<LeftKeys>(left);
+    const auto rightRows = Tuple_Traits::hashRows<RightKeys>(right);
+    if (left.size() <= right.size()) {
+        Tuple_Traits::joinPartition<LeftKeys, RightKeys>(leftRows.data(), leftRows.size(),
+                rightRows.data(), rightRows.size(), [&](const Left& l, const Right& r) {
+            result.push_back(tupleCat(l, r));
+        });
+    } else {
+        Tuple_Traits::joinPartition<RightKeys, LeftKeys>(rightRows.data(), rightRows.size(),
+                leftRows.data(), leftRows.size(), [&](const Right& r, const Left& l) {
+            result.push_back(tupleCat(l, r));
+        });
+    }
+    return result;
+}
+
+// same result set as hashJoin, but both inputs are first partitioned on hash bits so that
+// every build table stays cache resident. Rows come out grouped by partition.
+// radixBits == 0 picks about joinPartitionRows build rows per partition.
+template<typename LeftKeys, typename RightKeys, typename... L, typename... R>
+std::vector<Tuple_Traits::join_result_t<Tuple<L...>, Tuple<R...>>> radixHashJoin(const std::vector<Tuple<L...>>& left,
+                                                                                  const std::vector<Tuple<R...>>& right,
+                                                                                  unsigned radixBits = 0) {
+    static_assert(LeftKeys::size() == RightKeys::size(), "radixHashJoin: key column counts differ");
+    using Left = Tuple<L...>;
+    using Right = Tuple<R...>;
+
+    if (radixBits == 0) {
+        const std::size_t buildSize = std::min(left.size(), right.size());
+        while (radixBits < Tuple_Traits::joinMaxRadixBits &&
+               (buildSize >> radixBits) > Tuple_Traits::joinPartitionRows) {
+            ++radixBits;
+        }
+    }
+    if (radixBits == 0) {
+        return hashJoin<LeftKeys, RightKeys>(left, right);
+    }
+    assert(radixBits < std::numeric_limits<std::size_t>::digits);
+
+    std::vector<std::size_t> leftBounds, rightBounds;
+    const auto leftRows = Tuple_Traits::partitionRows(Tuple_Traits::hashRows<LeftKeys>(left), radixBits, leftBounds);
+    const auto rightRows = Tuple_Traits::partitionRows(Tuple_Traits::hashRows<RightKeys>(right), radixBits, rightBounds);
+
+    std::vector<Tuple_Traits::join_result_t<Left, Right>> result;
+    for (std::size_t p = 0; p + 1 < leftBounds.size(); ++p) {
+        const auto* l = leftRows.data() + leftBounds[p];
+        const auto* r = rightRows.data() + rightBounds[p];
+        const std::size_t leftSize = leftBounds[p + 1] - leftBounds[p];
+        const std::size_t rightSize = rightBounds[p + 1] - rightBounds[p];
+        if (leftSize == 0 || rightSize == 0) {
+            continue;
+        }
+        if (leftSize <= rightSize) {
+            Tuple_Traits::joinPartition<LeftKeys, RightKeys>(l, leftSize, r, rightSize,
+                    [&](const Left& lrow, const Right& rrow) {
+                result.push_back(tupleCat(lrow, rrow));
+            });
+        } else {
+            Tuple_Traits::joinPartition<RightKeys, LeftKeys>(r, rightSize, l, leftSize,
+                    [&](const Right& rrow, const Left& lrow) {
+                result.push_back(tupleCat(lrow, rrow));
+            });
+        }
+    }
+    return result;
+}
+
+#endif //TUPLE_TUPLE_JOIN_H
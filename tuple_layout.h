@@ -0,0 +1,108 @@
+#ifndef TUPLE_TUPLE_LAYOUT_H
+#define TUPLE_TUPLE_LAYOUT_H
+
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+#include "tuple.h"
+#include "tuple_trace.h"
+
+namespace Tuple_Traits {
+    // bytes an element occupies inside the tuple, references are stored as pointers
+    template<typename T>
+    constexpr std::size_t storageSize() {
+        return sizeof(std::conditional_t<std::is_reference<T>::value, void*, T>);
+    }
+
+    template<typename T>
+    constexpr std::size_t storageAlign() {
+        return alignof(std::conditional_t<std::is_reference<T>::value, void*, T>);
+    }
+
+    constexpr std::size_t payloadBytes(const Tuple<>*) {
+        return 0;
+    }
+
+    template<typename First, typename... T_other>
+    constexpr std::size_t payloadBytes(const Tuple<First, T_other...>*) {
+        return storageSize<First>() + payloadBytes(static_cast<const Tuple<T_other...>*>(nullptr));
+    }
+
+    template<typename T, std::size_t... I>
+    constexpr bool offsetsAscending(std::index_sequence<I...>) {
+        const std::size_t offsets[] = {0, tuple_tail_t<I, T>::valueOffset()...};
+        for (std::size_t i = 2; i < sizeof...(I) + 1; ++i) {
+            if (offsets[i] < offsets[i - 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// byte offset of element N from the start of the tuple
+template<int N, typename T>
+constexpr std::size_t tupleOffsetOf() {
+    return Tuple_Traits::tuple_tail_t<N, T>::valueOffset();
+}
+
+template<int N, typename T>
+constexpr std::size_t tupleSizeOf() {
+    return Tuple_Traits::storageSize<Tuple_Traits::tuple_element_t<N, T>>();
+}
+
+// sum of element sizes
+template<typename T>
+constexpr std::size_t tuplePayloadBytes() {
+    return Tuple_Traits::payloadBytes(static_cast<const T*>(nullptr));
+}
+
+// bytes of sizeof(T) not covered by any element, alignment holes and tail padding
+template<typename T>
+constexpr std::size_t tuplePaddingBytes() {
+    return sizeof(T) - tuplePayloadBytes<T>();
+}
+
+template<typename T>
+constexpr bool tupleIsPacked() {
+    return tuplePaddingBytes<T>() == 0;
+}
+
+// a Tuple with two or more elements keeps members in several classes of the hierarchy and is not
+// standard-layout, even when it is trivially copyable and packed
+template<typename T>
+constexpr bool tupleIsStandardLayout() {
+    return std::is_standard_layout<T>::value;
+}
+
+// element N + 1 lives after element N; false for the recursive layout, which stores element 0 last
+template<typename T>
+constexpr bool tupleOffsetsAscending() {
+    return Tuple_Traits::offsetsAscending<T>(std::make_index_sequence<T::size()>());
+}
+
+namespace Tuple_Traits {
+    template<typename T, std::size_t... I>
+    void printElements(std::ostream& out, std::index_sequence<I...>) {
+        const int rows[] = {0, ((out << "  [" << I << "] offset " << tupleOffsetOf<I, T>()
+                                    << " size " << tupleSizeOf<I, T>()
+                                    << " align " << storageAlign<tuple_element_t<I, T>>()
+                                    << ' ' << Tuple_Trace::demangle(typeid(tuple_element_t<I, T>).name()) << '\n'), 0)...};
+        static_cast<void>(rows);
+    }
+}
+
+template<typename T>
+void printTupleLayout(std::ostream& out) {
+    out << Tuple_Trace::demangle(typeid(T).name()) << '\n'
+        << "  size " << sizeof(T) << " align " << alignof(T) << " padding " << tuplePaddingBytes<T>()
+        << (tupleIsStandardLayout<T>() ? " standard-layout" : "")
+        << (std::is_trivially_copyable<T>::value ? " trivially-copyable" : "")
+        << (tupleOffsetsAscending<T>() ? " ascending" : " descending") << '\n';
+    Tuple_Traits::printElements<T>(out, std::make_index_sequence<T::size()>());
+}
+
+#endif //TUPLE_TUPLE_LAYOUT_H
@@ -0,0 +1,238 @@
+#ifndef TUPLE_TUPLE_MAP_H
+#define TUPLE_TUPLE_MAP_H
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+#include "tuple_hash.h"
+
+namespace Tuple_Traits {
+    // a Key from a tuple of the same values, e.g. Tuple<const std::string&, int> for
+    // Tuple<std::string, int>; a Key itself is forwarded
+    template<typename Key, typename K>
+    decltype(auto) makeKey(K&& key, std::true_type) {
+        return std::forward<K>(key);
+    }
+
+    template<typename Key, typename K, std::size_t... I>
+    Key makeKey(const K& key, std::index_sequence<I...>) {
+        return Key(get<I>(key)...);
+    }
+
+    template<typename Key, typename K>
+    Key makeKey(K&& key, std::false_type) {
+        return makeKey<Key>(key, std::make_index_sequence<Key::size()>());
+    }
+
+    // One shard of ConcurrentTupleMap. Entries are kept dense and found through a ProbeIndex of
+    // their positions that doubles at half load. Lookups compare the key's elements in place, so
+    // any tuple of comparable elements finds an entry.
+    template<typename Key, typename Value>
+    class MapShard {
+    public:
+        template<typename K>
+        Value* find(const K& key, std::size_t hash) {
+            const std::size_t slot = slotOf(key, hash);
+            return _index.holds(slot) ? &_entries[_index.position(slot)].value : nullptr;
+        }
+
+        // the caller has checked that the key is missing
+        template<typename V>
+        Value& insert(Key key, std::size_t hash, V&& value) {
+            if (_index.crowded(_entries.size() + 1)) {
+                _index.rebuild(2 * _index.slots(), _entries.size(), hashOf());
+            }
+            _entries.push_back({std::move(key), std::forward<V>(value), hash});
+            _index.link(hash, _entries.size() - 1);
+            return _entries.back().value;
+        }
+
+        template<typename K>
+        bool erase(const K& key, std::size_t hash) {
+            const std::size_t slot = slotOf(key, hash);
+            if (!_index.holds(slot)) {
+                return false;
+            }
+            const std::size_t position = _index.position(slot);
+            _index.unlink(slot, hashOf());
+            // the last entry fills the hole
+            if (position + 1 != _entries.size()) {
+                _index.place(_index.slotOf(_entries.back().hash, _entries.size() - 1), position);
+                _entries[position] = std::move(_entries.back());
+            }
+            _entries.pop_back();
+            return true;
+        }
+
+        std::size_t size() const {
+            return _entries.size();
+        }
+
+        void clear() {
+            _entries.clear();
+            _index = ProbeIndex<>();
+        }
+
+        template<typename F>
+        void forEach(F& f) const {
+            for (const Entry& entry : _entries) {
+                f(entry.key, entry.value);
+            }
+        }
+
+    private:
+        struct Entry {
+            Key key;
+            Value value;
+            std::size_t hash;
+        };
+
+        template<typename K>
+        std::size_t slotOf(const K& key, std::size_t hash) const {
+            return _index.find(hash, [&](std::size_t position) {
+                const Entry& entry = _entries[position];
+                return entry.hash == hash && columnsEqual(entry.key, key, all_columns_t<Key>(), all_columns_t<K>());
+            });
+        }
+
+        auto hashOf() const {
+            return [this](std::size_t position) {
+                return _entries[position].hash;
+            };
+        }
+
+        std::vector<Entry> _entries;
+        ProbeIndex<> _index;
+    };
+}
+
+// Hash map shared between threads, split into `shards` independently locked MapShards picked by
+// the high bits of the hash; threads only contend when their keys land in the same shard. Lookups
+// take any tuple with the key's element values, e.g. Tuple<const std::string&, int> for a
+// Tuple<std::string, int> key, hashed alike by Hash, so probing builds no Key. Values are copied
+// out, never referenced outside the lock.
+template<typename Key, typename Value, typename Hash = TupleHash>
+class ConcurrentTupleMap {
+public:
+    explicit ConcurrentTupleMap(std::size_t shards = 64) {
+        assert(shards > 0);
+        std::size_t count = 1;
+        while (count < shards) {
+            count <<= 1;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            _shards.emplace_back(new Shard());
+        }
+    }
+
+    // true if the key was inserted, false if an existing value was replaced
+    template<typename K, typename V>
+    bool insertOrAssign(K&& key, V&& value) {
+        const std::size_t hash = Hash()(key);
+        Shard& shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (Value* found = shard.table.find(key, hash)) {
+            *found = std::forward<V>(value);
+            return false;
+        }
+        shard.table.insert(Tuple_Traits::makeKey<Key>(std::forward<K>(key), is_key<K>()), hash, std::forward<V>(value));
+        return true;
+    }
+
+    // fn(value) under the shard's lock, on a default-constructed value if the key was missing;
+    // true if the key was inserted. fn must not call back into the map.
+    template<typename K, typename F>
+    bool upsert(K&& key, F&& fn) {
+        const std::size_t hash = Hash()(key);
+        Shard& shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (Value* found = shard.table.find(key, hash)) {
+            fn(*found);
+            return false;
+        }
+        fn(shard.table.insert(Tuple_Traits::makeKey<Key>(std::forward<K>(key), is_key<K>()), hash, Value()));
+        return true;
+    }
+
+    // copies the key's value into `value`, false if the key is missing
+    template<typename K>
+    bool find(const K& key, Value& value) const {
+        const std::size_t hash = Hash()(key);
+        Shard& shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (const Value* found = shard.table.find(key, hash)) {
+            value = *found;
+            return true;
+        }
+        return false;
+    }
+
+    template<typename K>
+    bool contains(const K& key) const {
+        const std::size_t hash = Hash()(key);
+        Shard& shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.table.find(key, hash) != nullptr;
+    }
+
+    template<typename K>
+    bool erase(const K& key) {
+        const std::size_t hash = Hash()(key);
+        Shard& shard = shardOf(hash);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.table.erase(key, hash);
+    }
+
+    // a snapshot per shard, not of the whole map while other threads write
+    std::size_t size() const {
+        std::size_t total = 0;
+        for (const std::unique_ptr<Shard>& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += shard->table.size();
+        }
+        return total;
+    }
+
+    void clear() {
+        for (const std::unique_ptr<Shard>& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->table.clear();
+        }
+    }
+
+    // f(key, value) for every entry, one shard locked at a time
+    template<typename F>
+    void forEach(F&& f) const {
+        for (const std::unique_ptr<Shard>& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->table.forEach(f);
+        }
+    }
+
+private:
+    template<typename K>
+    using is_key = std::is_same<std::decay_t<K>, Key>;
+
+    struct Shard {
+        std::mutex mutex;
+        Tuple_Traits::MapShard<Key, Value> table;
+        // keeps the locks of neighbouring shards off one cache line
+        char padding[64];
+    };
+
+    // the tables probe with the low bits, pick the shard with the high ones
+    Shard& shardOf(std::size_t hash) const {
+        return *_shards[(hash >> std::numeric_limits<std::size_t>::digits / 2) & (_shards.size() - 1)];
+    }
+
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+#endif //TUPLE_TUPLE_MAP_H
@@ -0,0 +1,580 @@
+#ifndef TUPLE_TUPLE_MAPPED_H
+#define TUPLE_TUPLE_MAPPED_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "tuple.h"
+
+// Read-only table of rows that is used straight from an mmap of its file. Rows keep the in-memory
+// layout of a Tuple, std::string columns are stored as (offset, size) into a string heap placed
+// after the rows. Opening checks the header and the column directory only, so it touches no row;
+// every string reference is checked against the heap when it is read.
+//
+//   header       MappedTableHeader
+//   columns      MappedColumn per element, checked against the reader's own layout
+//   rows         aligned to mappedRowsAlign, rows * rowSize bytes
+//   heap         string bytes
+
+namespace Tuple_Traits {
+    constexpr char mappedMagic[4] = {'T', 'P', 'L', 'M'};
+    constexpr std::uint32_t mappedVersion = 1;
+    constexpr std::uint32_t mappedEndianTag = 0x01020304;
+    constexpr std::uint64_t mappedRowsAlign = 64;
+
+    enum MappedKind : std::uint32_t {
+        MappedBytes = 0,
+        MappedSigned = 1,
+        MappedUnsigned = 2,
+        MappedFloat = 3,
+        MappedString = 4,
+    };
+
+    struct MappedTableHeader {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t endianTag;
+        std::uint32_t columns;
+        std::uint64_t rows;
+        std::uint64_t rowSize;
+        std::uint64_t rowAlign;
+        std::uint64_t rowsOffset;
+        std::uint64_t heapOffset;
+        std::uint64_t heapSize;
+    };
+
+    struct MappedColumn {
+        std::uint32_t kind;
+        std::uint32_t size;
+        std::uint64_t offset;
+    };
+
+    // a std::string column inside a stored row
+    struct MappedStringRef {
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    template<typename T>
+    struct mapped_storage {
+        static_assert(std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value,
+                      "MappedTupleTable: columns must be trivially copyable or std::string");
+        using type = T;
+    };
+
+    template<>
+    struct mapped_storage<std::string> {
+        using type = MappedStringRef;
+    };
+
+    template<typename T>
+    using mapped_storage_t = typename mapped_storage<T>::type;
+
+    template<typename T>
+    constexpr std::uint32_t mappedKind() {
+        return std::is_same<T, std::string>::value ? MappedString
+               : std::is_floating_point<T>::value ? MappedFloat
+               : std::is_integral<T>::value && std::is_signed<T>::value ? MappedSigned
+               : std::is_integral<T>::value ? MappedUnsigned : MappedBytes;
+    }
+
+    template<typename Stored, typename... T, std::size_t... I>
+    std::vector<MappedColumn> mappedColumns(std::index_sequence<I...>) {
+        return {MappedColumn{mappedKind<T>(), static_cast<std::uint32_t>(sizeof(mapped_storage_t<T>)),
+                             tuple_tail_t<I, Stored>::valueOffset()}...};
+    }
+
+    constexpr std::uint64_t alignUp(std::uint64_t value, std::uint64_t align) {
+        return (value + align - 1) / align * align;
+    }
+
+    // read-only mapping of a whole file; data() is null when the file is missing or empty
+    class FileMapping {
+    public:
+        FileMapping() = default;
+
+        explicit FileMapping(const std::string& path) {
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return;
+            }
+            struct stat status;
+            if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+                void* mapping = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                if (mapping != MAP_FAILED) {
+                    _data = static_cast<const char*>(mapping);
+                    _size = static_cast<std::size_t>(status.st_size);
+                }
+            }
+            ::close(fd);
+        }
+
+        FileMapping(const FileMapping&) = delete;
+        FileMapping& operator=(const FileMapping&) = delete;
+
+        FileMapping(FileMapping&& other) noexcept {
+            *this = std::move(other);
+        }
+
+        FileMapping& operator=(FileMapping&& other) noexcept {
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            return *this;
+        }
+
+        ~FileMapping() {
+            if (_data != nullptr) {
+                ::munmap(const_cast<char*>(_data), _size);
+            }
+        }
+
+        const char* data() const {
+            return _data;
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+    private:
+        const char* _data = nullptr;
+        std::size_t _size = 0;
+    };
+}
+
+// a string column value, it points into the mapping
+class MappedStringView {
+public:
+    MappedStringView(const char* data, std::size_t size) : _data(data), _size(size) {}
+
+    const char* data() const {
+        return _data;
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    std::string str() const {
+        return std::string(_data, _size);
+    }
+
+    int compare(const char* data, std::size_t size) const {
+        const int result = std::memcmp(_data, data, std::min(_size, size));
+        return result != 0 ? result : (_size < size ? -1 : (_size > size ? 1 : 0));
+    }
+
+    friend bool operator==(const MappedStringView& view, const std::string& value) {
+        return view.compare(value.data(), value.size()) == 0;
+    }
+
+    friend bool operator<(const MappedStringView& view, const std::string& value) {
+        return view.compare(value.data(), value.size()) < 0;
+    }
+
+    friend bool operator<(const std::string& value, const MappedStringView& view) {
+        return view.compare(value.data(), value.size()) > 0;
+    }
+
+private:
+    const char* _data;
+    std::size_t _size;
+};
+
+namespace Tuple_Traits {
+    // values are copied into zeroed row bytes at their offsets, so the padding between them is
+    // written as zeros and the file depends on the rows alone
+    template<typename T>
+    void storeMappedValue(char* slot, const T& value, std::string&) {
+        std::memcpy(slot, &value, sizeof(T));
+    }
+
+    inline void storeMappedValue(char* slot, const std::string& value, std::string& heap) {
+        const MappedStringRef stored = {heap.size(), value.size()};
+        std::memcpy(slot, &stored, sizeof(stored));
+        heap.append(value);
+    }
+
+    template<typename Stored, typename Row, std::size_t... I>
+    void storeMapped(char* stored, const Row& row, std::string& heap, std::index_sequence<I...>) {
+        const int copied[] = {0, (storeMappedValue(stored + tuple_tail_t<I, Stored>::valueOffset(), get<I>(row), heap), 0)...};
+        static_cast<void>(copied);
+    }
+
+    template<typename T>
+    const T& readMapped(const T& stored, const char*, std::size_t) {
+        return stored;
+    }
+
+    // a damaged reference throws std::out_of_range rather than read outside the mapping
+    inline MappedStringView readMapped(const MappedStringRef& stored, const char* heap, std::size_t heapSize) {
+        if (stored.offset > heapSize || stored.size > heapSize - stored.offset) {
+            throw std::out_of_range("MappedTupleTable: string outside the heap");
+        }
+        return MappedStringView(heap + stored.offset, static_cast<std::size_t>(stored.size));
+    }
+
+    template<typename T>
+    const T& materializeMapped(const T& value) {
+        return value;
+    }
+
+    inline std::string materializeMapped(const MappedStringView& value) {
+        return value.str();
+    }
+
+    template<typename T, typename K>
+    int compareMapped(const T& value, const K& key) {
+        return value < key ? -1 : (key < value ? 1 : 0);
+    }
+
+    inline int compareMapped(const MappedStringView& value, const std::string& key) {
+        return value.compare(key.data(), key.size());
+    }
+
+    inline int compareMapped(const MappedStringView& value, const char* key) {
+        return value.compare(key, std::strlen(key));
+    }
+}
+
+// writes rows in the given order; binary search on the table needs them sorted by the key columns
+template<typename... T>
+bool writeMappedTable(const std::string& path, const std::vector<Tuple<T...>>& rows) {
+    using Stored = Tuple<Tuple_Traits::mapped_storage_t<T>...>;
+    const std::vector<Tuple_Traits::MappedColumn> columns =
+            Tuple_Traits::mappedColumns<Stored, T...>(std::index_sequence_for<T...>());
+
+    Tuple_Traits::MappedTableHeader header = {};
+    std::memcpy(header.magic, Tuple_Traits::mappedMagic, sizeof(header.magic));
+    header.version = Tuple_Traits::mappedVersion;
+    header.endianTag = Tuple_Traits::mappedEndianTag;
+    header.columns = sizeof...(T);
+    header.rows = rows.size();
+    header.rowSize = sizeof(Stored);
+    header.rowAlign = alignof(Stored);
+    header.rowsOffset = Tuple_Traits::alignUp(sizeof(header) + columns.size() * sizeof(Tuple_Traits::MappedColumn),
+                                              std::max<std::uint64_t>(Tuple_Traits::mappedRowsAlign, alignof(Stored)));
+    header.heapOffset = header.rowsOffset + rows.size() * sizeof(Stored);
+
+    std::vector<char> stored(rows.size() * sizeof(Stored), 0);
+    std::string heap;
+    for (std::size_t r = 0; r < rows.size(); ++r) {
+        Tuple_Traits::storeMapped<Stored>(stored.data() + r * sizeof(Stored), rows[r], heap, std::index_sequence_for<T...>());
+    }
+    header.heapSize = heap.size();
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    const std::vector<char> padding(header.rowsOffset - sizeof(header) - columns.size() * sizeof(Tuple_Traits::MappedColumn));
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(columns.data(), sizeof(Tuple_Traits::MappedColumn), columns.size(), file) == columns.size() &&
+              std::fwrite(padding.data(), 1, padding.size(), file) == padding.size() &&
+              std::fwrite(stored.data(), 1, stored.size(), file) == stored.size() &&
+              std::fwrite(heap.data(), 1, heap.size(), file) == heap.size();
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+template<typename... T>
+class MappedTupleTable {
+public:
+    using Row = Tuple<T...>;
+    using Stored = Tuple<Tuple_Traits::mapped_storage_t<T>...>;
+
+    // one row of the mapping; get<N>() returns const T& or a MappedStringView for string columns
+    class RowRef {
+    public:
+        RowRef(const MappedTupleTable* table, const Stored* row) : _table(table), _row(row) {}
+
+        template<int N>
+        decltype(auto) get() const {
+            return _table->column<N>(*_row);
+        }
+
+        // a deserialized copy
+        Row load() const {
+            Row row;
+            loadColumns(row, std::index_sequence_for<T...>());
+            return row;
+        }
+
+    private:
+        template<std::size_t... I>
+        void loadColumns(Row& row, std::index_sequence<I...>) const {
+            const int loaded[] = {0, (::get<I>(row) = Tuple_Traits::materializeMapped(get<I>()), 0)...};
+            static_cast<void>(loaded);
+        }
+
+        const MappedTupleTable* _table;
+        const Stored* _row;
+    };
+
+    // random access over RowRef values; operator-> hands out a RowRef held by the returned proxy
+    class iterator {
+    public:
+        class pointer {
+        public:
+            explicit pointer(RowRef row) : _row(row) {}
+
+            const RowRef* operator->() const {
+                return &_row;
+            }
+
+        private:
+            RowRef _row;
+        };
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = RowRef;
+        using difference_type = std::ptrdiff_t;
+        using reference = RowRef;
+
+        iterator() : _table(nullptr), _index(0) {}
+
+        iterator(const MappedTupleTable* table, std::size_t index) : _table(table), _index(index) {}
+
+        RowRef operator*() const {
+            return (*_table)[_index];
+        }
+
+        pointer operator->() const {
+            return pointer(**this);
+        }
+
+        RowRef operator[](difference_type n) const {
+            return (*_table)[_index + n];
+        }
+
+        iterator& operator++() {
+            ++_index;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator old = *this;
+            ++_index;
+            return old;
+        }
+
+        iterator& operator--() {
+            --_index;
+            return *this;
+        }
+
+        iterator operator--(int) {
+            iterator old = *this;
+            --_index;
+            return old;
+        }
+
+        iterator& operator+=(difference_type n) {
+            _index += n;
+            return *this;
+        }
+
+        iterator& operator-=(difference_type n) {
+            _index -= n;
+            return *this;
+        }
+
+        iterator operator+(difference_type n) const {
+            return iterator(_table, _index + n);
+        }
+
+        friend iterator operator+(difference_type n, const iterator& it) {
+            return it + n;
+        }
+
+        iterator operator-(difference_type n) const {
+            return iterator(_table, _index - n);
+        }
+
+        difference_type operator-(const iterator& other) const {
+            return static_cast<difference_type>(_index) - static_cast<difference_type>(other._index);
+        }
+
+        bool operator==(const iterator& other) const {
+            return _index == other._index;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return _index != other._index;
+        }
+
+        bool operator<(const iterator& other) const {
+            return _index < other._index;
+        }
+
+        bool operator>(const iterator& other) const {
+            return _index > other._index;
+        }
+
+        bool operator<=(const iterator& other) const {
+            return _index <= other._index;
+        }
+
+        bool operator>=(const iterator& other) const {
+            return _index >= other._index;
+        }
+
+    private:
+        const MappedTupleTable* _table;
+        std::size_t _index;
+    };
+
+    explicit MappedTupleTable(const std::string& path) : _file(path) {
+        _valid = _file.data() != nullptr && validate();
+    }
+
+    MappedTupleTable(const MappedTupleTable&) = delete;
+    MappedTupleTable& operator=(const MappedTupleTable&) = delete;
+
+    MappedTupleTable(MappedTupleTable&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    MappedTupleTable& operator=(MappedTupleTable&& other) noexcept {
+        std::swap(_file, other._file);
+        std::swap(_rows, other._rows);
+        std::swap(_size, other._size);
+        std::swap(_heap, other._heap);
+        std::swap(_heapSize, other._heapSize);
+        std::swap(_valid, other._valid);
+        return *this;
+    }
+
+    // false when the file is missing, truncated, or was written for another layout or version; a
+    // string outside the heap is only found when it is read, which throws std::out_of_range
+    bool valid() const {
+        return _valid;
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    RowRef operator[](std::size_t index) const {
+        assert(index < _size);
+        return RowRef(this, _rows + index);
+    }
+
+    template<int N>
+    decltype(auto) get(std::size_t index) const {
+        assert(index < _size);
+        return column<N>(_rows[index]);
+    }
+
+    iterator begin() const {
+        return iterator(this, 0);
+    }
+
+    iterator end() const {
+        return iterator(this, _size);
+    }
+
+    // first row whose leading columns are not less than key, rows must be sorted on them
+    template<typename... K>
+    std::size_t lowerBound(const Tuple<K...>& key) const {
+        return bound(key, [](int order) { return order < 0; });
+    }
+
+    // first row whose leading columns are greater than key
+    template<typename... K>
+    std::size_t upperBound(const Tuple<K...>& key) const {
+        return bound(key, [](int order) { return order <= 0; });
+    }
+
+private:
+    template<int N>
+    decltype(auto) column(const Stored& row) const {
+        return Tuple_Traits::readMapped(::get<N>(row), _heap, _heapSize);
+    }
+
+    template<typename... K, typename Before>
+    std::size_t bound(const Tuple<K...>& key, Before before) const {
+        static_assert(sizeof...(K) <= sizeof...(T), "MappedTupleTable: key has more columns than the rows");
+        std::size_t first = 0;
+        std::size_t count = _size;
+        while (count > 0) {
+            const std::size_t step = count / 2;
+            if (before(compareKey(_rows[first + step], key, std::index_sequence_for<K...>()))) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    template<typename... K, std::size_t... I>
+    int compareKey(const Stored& row, const Tuple<K...>& key, std::index_sequence<I...>) const {
+        int order = 0;
+        const int compared[] = {0, (order = order != 0 ? order
+                : Tuple_Traits::compareMapped(column<I>(row), ::get<I>(key)), 0)...};
+        static_cast<void>(compared);
+        return order;
+    }
+
+    bool validate() {
+        using Tuple_Traits::MappedTableHeader;
+        using Tuple_Traits::MappedColumn;
+        const char* mapping = _file.data();
+        const std::size_t mappingSize = _file.size();
+        if (mappingSize < sizeof(MappedTableHeader)) {
+            return false;
+        }
+        MappedTableHeader header;
+        std::memcpy(&header, mapping, sizeof(header));
+        const std::vector<MappedColumn> expected =
+                Tuple_Traits::mappedColumns<Stored, T...>(std::index_sequence_for<T...>());
+        const std::uint64_t columnsEnd = sizeof(header) + expected.size() * sizeof(MappedColumn);
+        if (std::memcmp(header.magic, Tuple_Traits::mappedMagic, sizeof(header.magic)) != 0 ||
+            header.version != Tuple_Traits::mappedVersion || header.endianTag != Tuple_Traits::mappedEndianTag ||
+            header.columns != sizeof...(T) || header.rowSize != sizeof(Stored) || header.rowAlign != alignof(Stored) ||
+            header.rowsOffset % alignof(Stored) != 0 || header.rowsOffset < columnsEnd ||
+            header.rowsOffset > mappingSize || header.rows > (mappingSize - header.rowsOffset) / sizeof(Stored) ||
+            header.heapOffset != header.rowsOffset + header.rows * sizeof(Stored) ||
+            header.heapSize > mappingSize - header.heapOffset) {
+            return false;
+        }
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            MappedColumn stored;
+            std::memcpy(&stored, mapping + sizeof(header) + i * sizeof(MappedColumn), sizeof(stored));
+            if (stored.kind != expected[i].kind || stored.size != expected[i].size || stored.offset != expected[i].offset) {
+                return false;
+            }
+        }
+        _rows = reinterpret_cast<const Stored*>(mapping + header.rowsOffset);
+        _size = static_cast<std::size_t>(header.rows);
+        _heap = mapping + header.heapOffset;
+        _heapSize = static_cast<std::size_t>(header.heapSize);
+        return true;
+    }
+
+    Tuple_Traits::FileMapping _file;
+    const Stored* _rows = nullptr;
+    std::size_t _size = 0;
+    const char* _heap = nullptr;
+    std::size_t _heapSize = 0;
+    bool _valid = false;
+};
+
+#endif //TUPLE_TUPLE_MAPPED_H
@@ -0,0 +1,307 @@
+#ifndef TUPLE_TUPLE_MEMO_H
+#define TUPLE_TUPLE_MEMO_H
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+#include "tuple_hash.h"
+
+namespace Tuple_Traits {
+    // result and parameter types of a function pointer or of a class with one operator()
+    template<typename F>
+    struct function_traits : function_traits<decltype(&F::operator())> {
+    };
+
+    template<typename R, typename... A>
+    struct function_traits<R(*)(A...)> {
+        using result_type = R;
+        using key_type = Tuple<std::decay_t<A>...>;
+    };
+
+    template<typename R, typename C, typename... A>
+    struct function_traits<R(C::*)(A...)> : function_traits<R(*)(A...)> {
+    };
+
+    template<typename R, typename C, typename... A>
+    struct function_traits<R(C::*)(A...) const> : function_traits<R(*)(A...)> {
+    };
+
+    // equal to TupleHash of the tuple the arguments would form
+    template<typename... A>
+    std::size_t hashArguments(const A&... arguments) {
+        std::size_t seed = 0;
+        const int hashed[] = {0, (seed = hashCombine(seed, hashValue(arguments)), 0)...};
+        static_cast<void>(hashed);
+        return mixHash(seed);
+    }
+
+    template<typename Key, std::size_t... I, typename... A>
+    bool keyEquals(const Key& key, std::index_sequence<I...>, const A&... arguments) {
+        bool equal = true;
+        const int compared[] = {0, (equal = equal && get<I>(key) == arguments, 0)...};
+        static_cast<void>(compared);
+        return equal;
+    }
+
+    // Fixed number of entries with CLOCK eviction: a hit sets the entry's referenced bit, and the
+    // hand clears bits as it sweeps until it finds an entry that was not used since its last pass.
+    // The ProbeIndex of entry positions is probed with the argument values themselves, so a hit
+    // builds no key.
+    template<typename Key, typename Result>
+    class MemoTable {
+    public:
+        explicit MemoTable(std::size_t capacity) : _capacity(capacity), _index(indexSize(capacity)) {
+            assert(capacity > 0);
+            _entries.reserve(capacity);
+        }
+
+        template<typename... A>
+        const Result* find(std::size_t hash, const A&... arguments) {
+            const std::size_t slot = _index.find(hash, [&](std::size_t position) {
+                const Entry& entry = _entries[position];
+                return entry.hash == hash && keyEquals(entry.key, std::index_sequence_for<A...>(), arguments...);
+            });
+            if (!_index.holds(slot)) {
+                return nullptr;
+            }
+            Entry& entry = _entries[_index.position(slot)];
+            entry.referenced = true;
+            return &entry.result;
+        }
+
+        // the caller has checked that the key is missing
+        void insert(std::size_t hash, Key key, Result result) {
+            std::size_t slot;
+            if (_entries.size() < _capacity) {
+                slot = _entries.size();
+                _entries.push_back({std::move(key), std::move(result), hash, false});
+            } else {
+                slot = evict();
+                _entries[slot] = {std::move(key), std::move(result), hash, false};
+            }
+            _index.link(hash, slot);
+        }
+
+        std::size_t size() const {
+            return _entries.size();
+        }
+
+        std::size_t capacity() const {
+            return _capacity;
+        }
+
+        void clear() {
+            _entries.clear();
+            _index.clear();
+            _hand = 0;
+        }
+
+    private:
+        struct Entry {
+            Key key;
+            Result result;
+            std::size_t hash;
+            bool referenced;
+        };
+
+        static std::size_t indexSize(std::size_t capacity) {
+            std::size_t size = 1;
+            while (size < 2 * capacity) {
+                size <<= 1;
+            }
+            return size;
+        }
+
+        // frees the next entry the hand finds unreferenced and unlinks it from the index
+        std::size_t evict() {
+            while (_entries[_hand].referenced) {
+                _entries[_hand].referenced = false;
+                _hand = (_hand + 1) % _capacity;
+            }
+            const std::size_t slot = _hand;
+            _hand = (_hand + 1) % _capacity;
+            _index.unlink(_index.slotOf(_entries[slot].hash, slot), [this](std::size_t position) {
+                return _entries[position].hash;
+            });
+            return slot;
+        }
+
+        std::size_t _capacity;
+        std::vector<Entry> _entries;
+        ProbeIndex<> _index;
+        std::size_t _hand = 0;
+    };
+}
+
+// Caches the results of a pure function, keyed on Tuple<decayed parameter types>. Arguments are
+// hashed and compared in place, so a hit copies nothing but the result; a miss calls the function
+// and stores a key made from the arguments. At most `capacity` results are kept, CLOCK eviction.
+// Not thread-safe, see ShardedMemoized.
+template<typename F>
+class Memoized {
+public:
+    using result_type = std::decay_t<typename Tuple_Traits::function_traits<F>::result_type>;
+    using key_type = typename Tuple_Traits::function_traits<F>::key_type;
+
+    static_assert(!std::is_void<result_type>::value, "memoize: the function returns nothing to cache");
+
+    Memoized(F f, std::size_t capacity) : _f(std::move(f)), _table(capacity) {
+    }
+
+    template<typename... A>
+    result_type operator()(const A&... arguments) {
+        return call(std::is_same<Tuple<A...>, key_type>(), arguments...);
+    }
+
+    std::size_t hits() const {
+        return _hits;
+    }
+
+    std::size_t misses() const {
+        return _misses;
+    }
+
+    std::size_t size() const {
+        return _table.size();
+    }
+
+    void clear() {
+        _table.clear();
+    }
+
+private:
+    // arguments of other types, e.g. a string literal for a std::string parameter, are converted
+    // first, otherwise their hash would differ
+    template<typename... A>
+    result_type call(std::false_type, const A&... arguments) {
+        const key_type key(arguments...);
+        return callWith(key, std::make_index_sequence<key_type::size()>());
+    }
+
+    template<std::size_t... I>
+    result_type callWith(const key_type& key, std::index_sequence<I...>) {
+        return call(std::true_type(), get<I>(key)...);
+    }
+
+    template<typename... A>
+    result_type call(std::true_type, const A&... arguments) {
+        const std::size_t hash = Tuple_Traits::hashArguments(arguments...);
+        if (const result_type* found = _table.find(hash, arguments...)) {
+            ++_hits;
+            return *found;
+        }
+        ++_misses;
+        result_type result = _f(arguments...);
+        _table.insert(hash, key_type(arguments...), result);
+        return result;
+    }
+
+    F _f;
+    Tuple_Traits::MemoTable<key_type, result_type> _table;
+    std::size_t _hits = 0;
+    std::size_t _misses = 0;
+};
+
+// Thread-safe Memoized: the hash picks one of `shards` independently locked tables of
+// capacity / shards entries. The function runs outside the lock, so two threads missing on the
+// same key may both compute it and the second result is dropped.
+template<typename F>
+class ShardedMemoized {
+public:
+    using result_type = typename Memoized<F>::result_type;
+    using key_type = typename Memoized<F>::key_type;
+
+    ShardedMemoized(F f, std::size_t capacity, std::size_t shards = 16) : _f(std::move(f)) {
+        assert(shards > 0 && capacity >= shards);
+        for (std::size_t i = 0; i < shards; ++i) {
+            _shards.emplace_back(new Shard(capacity / shards));
+        }
+    }
+
+    template<typename... A>
+    result_type operator()(const A&... arguments) {
+        return call(std::is_same<Tuple<A...>, key_type>(), arguments...);
+    }
+
+    std::size_t hits() const {
+        return sum(&Shard::hits);
+    }
+
+    std::size_t misses() const {
+        return sum(&Shard::misses);
+    }
+
+private:
+    struct Shard {
+        explicit Shard(std::size_t capacity) : table(capacity) {
+        }
+
+        std::mutex mutex;
+        Tuple_Traits::MemoTable<key_type, result_type> table;
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+    };
+
+    template<typename... A>
+    result_type call(std::false_type, const A&... arguments) {
+        const key_type key(arguments...);
+        return callWith(key, std::make_index_sequence<key_type::size()>());
+    }
+
+    template<std::size_t... I>
+    result_type callWith(const key_type& key, std::index_sequence<I...>) {
+        return call(std::true_type(), get<I>(key)...);
+    }
+
+    template<typename... A>
+    result_type call(std::true_type, const A&... arguments) {
+        const std::size_t hash = Tuple_Traits::hashArguments(arguments...);
+        // the table probes with the low bits, pick the shard with the high ones
+        Shard& shard = *_shards[(hash >> std::numeric_limits<std::size_t>::digits / 2) % _shards.size()];
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (const result_type* found = shard.table.find(hash, arguments...)) {
+                ++shard.hits;
+                return *found;
+            }
+            ++shard.misses;
+        }
+        result_type result = _f(arguments...);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!shard.table.find(hash, arguments...)) {
+            shard.table.insert(hash, key_type(arguments...), result);
+        }
+        return result;
+    }
+
+    std::size_t sum(std::size_t Shard::* counter) const {
+        std::size_t total = 0;
+        for (const std::unique_ptr<Shard>& shard : _shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            total += (*shard).*counter;
+        }
+        return total;
+    }
+
+    F _f;
+    std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+template<typename F>
+Memoized<std::decay_t<F>> memoize(F&& f, std::size_t capacity) {
+    return Memoized<std::decay_t<F>>(std::forward<F>(f), capacity);
+}
+
+template<typename F>
+ShardedMemoized<std::decay_t<F>> memoizeConcurrent(F&& f, std::size_t capacity, std::size_t shards = 16) {
+    return ShardedMemoized<std::decay_t<F>>(std::forward<F>(f), capacity, shards);
+}
+
+#endif //TUPLE_TUPLE_MEMO_H
@@ -0,0 +1,152 @@
+#ifndef TUPLE_TUPLE_ORDER_H
+#define TUPLE_TUPLE_ORDER_H
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "tuple.h"
+
+// what counts as NULL for NullsFirst / NullsLast: null pointers, smart pointers and NaN;
+// specialize for other nullable column types
+template<typename T, typename = void>
+struct TupleNullTraits {
+    constexpr static bool isNull(const T&) {
+        return false;
+    }
+};
+
+template<typename T>
+struct TupleNullTraits<T*> {
+    constexpr static bool isNull(const T* value) {
+        return value == nullptr;
+    }
+};
+
+template<typename T, typename D>
+struct TupleNullTraits<std::unique_ptr<T, D>> {
+    static bool isNull(const std::unique_ptr<T, D>& value) {
+        return !value;
+    }
+};
+
+template<typename T>
+struct TupleNullTraits<std::shared_ptr<T>> {
+    static bool isNull(const std::shared_ptr<T>& value) {
+        return !value;
+    }
+};
+
+template<typename T>
+struct TupleNullTraits<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+    static bool isNull(T value) {
+        return std::isnan(value);
+    }
+};
+
+// ORDER BY keys: column N ascending or descending under Compare, which can be any stateless
+// comparator, e.g. a case-insensitive collation for strings
+template<int N, typename Compare = std::less<>>
+struct Asc {
+    template<typename Left, typename Right>
+    constexpr static bool before(const Left& left, const Right& right) {
+        return Compare()(get<N>(left), get<N>(right));
+    }
+
+    constexpr static int column() {
+        return N;
+    }
+};
+
+template<int N, typename Compare = std::less<>>
+struct Desc {
+    template<typename Left, typename Right>
+    constexpr static bool before(const Left& left, const Right& right) {
+        return Compare()(get<N>(right), get<N>(left));
+    }
+
+    constexpr static int column() {
+        return N;
+    }
+};
+
+// NULLs of column N after, or before, all other values, which are ordered by Key
+template<int N, typename Key = Asc<N>>
+struct NullsLast {
+    template<typename Left, typename Right>
+    static bool before(const Left& left, const Right& right) {
+        const bool leftNull = TupleNullTraits<std::decay_t<decltype(get<N>(left))>>::isNull(get<N>(left));
+        const bool rightNull = TupleNullTraits<std::decay_t<decltype(get<N>(right))>>::isNull(get<N>(right));
+        if (leftNull || rightNull) {
+            return !leftNull;
+        }
+        return Key::before(left, right);
+    }
+
+    constexpr static int column() {
+        return N;
+    }
+};
+
+template<int N, typename Key = Asc<N>>
+struct NullsFirst {
+    template<typename Left, typename Right>
+    static bool before(const Left& left, const Right& right) {
+        const bool leftNull = TupleNullTraits<std::decay_t<decltype(get<N>(left))>>::isNull(get<N>(left));
+        const bool rightNull = TupleNullTraits<std::decay_t<decltype(get<N>(right))>>::isNull(get<N>(right));
+        if (leftNull || rightNull) {
+            return leftNull && !rightNull;
+        }
+        return Key::before(left, right);
+    }
+
+    constexpr static int column() {
+        return N;
+    }
+};
+
+namespace Tuple_Traits {
+    template<typename Left, typename Right>
+    constexpr bool orderedBefore(const Left&, const Right&) {
+        return false;
+    }
+
+    // the first key that tells the rows apart decides, every key is inlined into the next
+    template<typename Key, typename... Other, typename Left, typename Right>
+    constexpr bool orderedBefore(const Left& left, const Right& right) {
+        return Key::before(left, right) || (!Key::before(right, left) && orderedBefore<Other...>(left, right));
+    }
+}
+
+// strict weak order over Tuples given by a list of keys, e.g.
+// std::sort(rows.begin(), rows.end(), orderBy<Desc<2>, Asc<0>, NullsLast<3>>);
+// usable as the Less of std::sort, TuplePriorityQueue, ExternalSorter and the heap algorithms
+template<typename... Keys>
+struct OrderBy {
+    static_assert(sizeof...(Keys) > 0, "OrderBy: no keys");
+
+    template<typename Left, typename Right>
+    constexpr bool operator()(const Left& left, const Right& right) const {
+        return Tuple_Traits::orderedBefore<Keys...>(left, right);
+    }
+};
+
+template<typename... Keys>
+constexpr OrderBy<Keys...> orderBy{};
+
+namespace Tuple_Traits {
+    template<typename Row, typename Less>
+    struct key_direction;
+
+    // TuplePriorityQueue caches the leading column when the order starts with it under std::less<>
+    template<typename Row, typename... Other>
+    struct key_direction<Row, OrderBy<Asc<0>, Other...>> : std::integral_constant<int, 1> {
+    };
+
+    template<typename Row, typename... Other>
+    struct key_direction<Row, OrderBy<Desc<0>, Other...>> : std::integral_constant<int, -1> {
+    };
+}
+
+#endif //TUPLE_TUPLE_ORDER_H
@@ -0,0 +1,328 @@
+#ifndef TUPLE_TUPLE_QUEUE_H
+#define TUPLE_TUPLE_QUEUE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+
+namespace Tuple_Traits {
+    constexpr std::size_t queueNoPosition = std::numeric_limits<std::size_t>::max();
+
+    // leading columns that map onto an unsigned 64-bit key with the same order
+    template<typename T>
+    struct is_normalizable : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value ||
+                                                          std::is_same<T, float>::value ||
+                                                          std::is_same<T, double>::value> {
+    };
+
+    template<typename T>
+    constexpr std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value, std::uint64_t>
+    normalizeKey(T value) {
+        return value;
+    }
+
+    // flipping the sign bit moves negative values below positive ones
+    template<typename T>
+    constexpr std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value, std::uint64_t>
+    normalizeKey(T value) {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(value)) ^ (std::uint64_t(1) << 63);
+    }
+
+    template<typename T>
+    constexpr std::enable_if_t<std::is_enum<T>::value, std::uint64_t> normalizeKey(T value) {
+        return normalizeKey(static_cast<std::underlying_type_t<T>>(value));
+    }
+
+    // IEEE bits order like sign-magnitude integers; -0.0 folds onto 0.0 because operator< ties them
+    template<typename T>
+    std::enable_if_t<std::is_floating_point<T>::value, std::uint64_t> normalizeKey(T value) {
+        const double widened = value == 0 ? 0.0 : static_cast<double>(value);
+        std::uint64_t bits;
+        std::memcpy(&bits, &widened, sizeof(bits));
+        return bits >> 63 ? ~bits : bits | (std::uint64_t(1) << 63);
+    }
+
+    // +1 when Less orders rows ascending by operator<, -1 when descending, 0 when unknown
+    template<typename Row, typename Less>
+    struct key_direction : std::integral_constant<int, 0> {
+    };
+
+    template<typename Row>
+    struct key_direction<Row, std::less<Row>> : std::integral_constant<int, 1> {
+    };
+
+    template<typename Row>
+    struct key_direction<Row, std::less<>> : std::integral_constant<int, 1> {
+    };
+
+    template<typename Row>
+    struct key_direction<Row, std::greater<Row>> : std::integral_constant<int, -1> {
+    };
+
+    template<typename Row>
+    struct key_direction<Row, std::greater<>> : std::integral_constant<int, -1> {
+    };
+
+    template<typename Row, typename Less>
+    struct can_cache_key : std::integral_constant<bool, key_direction<Row, Less>::value != 0 &&
+                                                        is_normalizable<tuple_element_t<0, Row>>::value> {
+    };
+
+    template<bool Cached>
+    struct QueueEntry {
+        std::size_t slot;
+    };
+
+    template<>
+    struct QueueEntry<true> {
+        std::uint64_t key;
+        std::size_t slot;
+    };
+}
+
+// Priority queue of Tuples on an Arity-ary heap, with the same order as std::priority_queue:
+// top() is the greatest row under Less, so std::greater<Row> gives a min-queue.
+// The heap only moves small {key, slot} entries; rows stay in place and every push returns a
+// handle for update(), decreaseKey() and erase(). When Less is std::less or std::greater and the
+// first column is an arithmetic type, a normalized copy of it is cached in the entry and the full
+// row comparison only runs on ties. CacheKey = false turns the cache off.
+template<typename Row, typename Less = std::less<Row>, std::size_t Arity = 4, bool CacheKey = true>
+class TuplePriorityQueue {
+    static_assert(Arity >= 2, "TuplePriorityQueue: arity must be at least 2");
+    static_assert(Tuple_Traits::is_tuple<Row>::value && Row::size() > 0, "TuplePriorityQueue: rows must be non-empty Tuples");
+
+    constexpr static bool cached = CacheKey && Tuple_Traits::can_cache_key<Row, Less>::value;
+    using Entry = Tuple_Traits::QueueEntry<cached>;
+
+public:
+    using Handle = std::size_t;
+
+    explicit TuplePriorityQueue(Less less = Less()) : _less(less) {
+    }
+
+    constexpr static bool cachesKey() {
+        return cached;
+    }
+
+    bool empty() const {
+        return _heap.empty();
+    }
+
+    std::size_t size() const {
+        return _heap.size();
+    }
+
+    void reserve(std::size_t count) {
+        _heap.reserve(count);
+        _rows.reserve(count);
+        _positions.reserve(count);
+    }
+
+    const Row& top() const {
+        assert(!empty());
+        return _rows[_heap.front().slot];
+    }
+
+    Handle topHandle() const {
+        assert(!empty());
+        return _heap.front().slot;
+    }
+
+    // true while the handle's row is queued, handles of popped rows are reused by later pushes
+    bool contains(Handle handle) const {
+        return handle < _positions.size() && _positions[handle] != Tuple_Traits::queueNoPosition;
+    }
+
+    const Row& operator[](Handle handle) const {
+        assert(contains(handle));
+        return _rows[handle];
+    }
+
+    Handle push(Row row) {
+        Handle handle;
+        if (_free.empty()) {
+            handle = _rows.size();
+            _rows.push_back(std::move(row));
+            _positions.push_back(_heap.size());
+        } else {
+            handle = _free.back();
+            _free.pop_back();
+            _rows[handle] = std::move(row);
+        }
+        _heap.push_back(makeEntry(handle));
+        siftUp(_heap.size() - 1);
+        return handle;
+    }
+
+    void pop() {
+        assert(!empty());
+        erase(_heap.front().slot);
+    }
+
+    // moves the top row out and pops it
+    Row takeTop() {
+        assert(!empty());
+        const Handle handle = _heap.front().slot;
+        Row row = std::move(_rows[handle]);
+        erase(handle);
+        return row;
+    }
+
+    void erase(Handle handle) {
+        assert(contains(handle));
+        const std::size_t position = _positions[handle];
+        _positions[handle] = Tuple_Traits::queueNoPosition;
+        _free.push_back(handle);
+        const Entry last = _heap.back();
+        _heap.pop_back();
+        if (position < _heap.size()) {
+            // the last leaf usually belongs near the bottom again: move the hole down along the
+            // better children first and sift up from there, one comparison per child instead of two
+            place(descendHole(position), last);
+            siftUp(_positions[last.slot]);
+        }
+    }
+
+    // replaces the row and restores the heap in whichever direction it moved
+    void update(Handle handle, Row row) {
+        assert(contains(handle));
+        _rows[handle] = std::move(row);
+        const std::size_t position = _positions[handle];
+        _heap[position] = makeEntry(handle);
+        siftUp(position);
+        siftDown(_positions[handle]);
+    }
+
+    // the row may only move toward the top: with std::greater<Row> a smaller key, as in Dijkstra
+    void decreaseKey(Handle handle, Row row) {
+        assert(contains(handle));
+        assert(!higher(_rows[handle], row));
+        _rows[handle] = std::move(row);
+        const std::size_t position = _positions[handle];
+        _heap[position] = makeEntry(handle);
+        siftUp(position);
+    }
+
+    void clear() {
+        _heap.clear();
+        _rows.clear();
+        _positions.clear();
+        _free.clear();
+    }
+
+private:
+    static std::uint64_t leadingKey(const Row& row, std::true_type) {
+        const std::uint64_t key = Tuple_Traits::normalizeKey(get<0>(row));
+        return Tuple_Traits::key_direction<Row, Less>::value > 0 ? key : ~key;
+    }
+
+    Entry makeEntry(Handle handle, std::true_type) const {
+        return {leadingKey(_rows[handle], std::true_type()), handle};
+    }
+
+    Entry makeEntry(Handle handle, std::false_type) const {
+        return {handle};
+    }
+
+    Entry makeEntry(Handle handle) const {
+        return makeEntry(handle, std::integral_constant<bool, cached>());
+    }
+
+    // first belongs above second in the heap
+    bool higher(const Row& first, const Row& second) const {
+        return _less(second, first);
+    }
+
+    bool higher(const Entry& first, const Entry& second, std::true_type) const {
+        if (first.key != second.key) {
+            return first.key > second.key;
+        }
+        return higher(_rows[first.slot], _rows[second.slot]);
+    }
+
+    bool higher(const Entry& first, const Entry& second, std::false_type) const {
+        return higher(_rows[first.slot], _rows[second.slot]);
+    }
+
+    bool higher(const Entry& first, const Entry& second) const {
+        return higher(first, second, std::integral_constant<bool, cached>());
+    }
+
+    void place(std::size_t position, const Entry& entry) {
+        _heap[position] = entry;
+        _positions[entry.slot] = position;
+    }
+
+    void siftUp(std::size_t position) {
+        const Entry entry = _heap[position];
+        while (position > 0) {
+            const std::size_t parent = (position - 1) / Arity;
+            if (!higher(entry, _heap[parent])) {
+                break;
+            }
+            place(position, _heap[parent]);
+            position = parent;
+        }
+        place(position, entry);
+    }
+
+    // promotes the best child into `position` down to a leaf, returns the leaf position
+    std::size_t descendHole(std::size_t position) {
+        const std::size_t count = _heap.size();
+        for (;;) {
+            const std::size_t first = position * Arity + 1;
+            if (first >= count) {
+                return position;
+            }
+            const std::size_t last = first + Arity < count ? first + Arity : count;
+            std::size_t best = first;
+            for (std::size_t child = first + 1; child < last; ++child) {
+                if (higher(_heap[child], _heap[best])) {
+                    best = child;
+                }
+            }
+            place(position, _heap[best]);
+            position = best;
+        }
+    }
+
+    void siftDown(std::size_t position) {
+        const Entry entry = _heap[position];
+        const std::size_t count = _heap.size();
+        for (;;) {
+            const std::size_t first = position * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+            const std::size_t last = first + Arity < count ? first + Arity : count;
+            std::size_t best = first;
+            for (std::size_t child = first + 1; child < last; ++child) {
+                if (higher(_heap[child], _heap[best])) {
+                    best = child;
+                }
+            }
+            if (!higher(_heap[best], entry)) {
+                break;
+            }
+            place(position, _heap[best]);
+            position = best;
+        }
+        place(position, entry);
+    }
+
+    Less _less;
+    std::vector<Entry> _heap;
+    std::vector<Row> _rows;
+    std::vector<std::size_t> _positions;
+    std::vector<Handle> _free;
+};
+
+#endif //TUPLE_TUPLE_QUEUE_H
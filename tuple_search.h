@@ -0,0 +1,98 @@
+#ifndef TUPLE_TUPLE_SEARCH_H
+#define TUPLE_TUPLE_SEARCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "tuple.h"
+
+namespace Tuple_Traits {
+    // queries searched in lockstep: enough independent cache misses in flight to hide memory latency
+    constexpr std::size_t searchGroup = 16;
+
+    // Tuple_Traits::lower(row, key) after the leading columns were found equal
+    template<typename Row, typename Key>
+    bool lowerTail(const Row&, const Key&, std::true_type) {
+        return false;
+    }
+
+    template<typename Row, typename Key>
+    bool lowerTail(const Row& row, const Key& key, std::false_type) {
+        return lower(row.next(), key.next());
+    }
+
+    // Branchless lower_bound of `count` queries at once. Every search of a group halves a window of
+    // the same length, so they take the same number of steps and only their bases differ; each step
+    // gathers the probed leading values, compares them against the query keys in one loop the
+    // compiler vectorizes, settles leading-column ties with the rest of the row, then prefetches the
+    // exact row each search probes next.
+    template<typename Row, typename Queries>
+    void lowerBoundGroup(const Row* rows, std::size_t size, const Queries& queries, std::size_t first,
+                         std::size_t count, std::size_t* result) {
+        using Lead = std::decay_t<tuple_element_t<0, Row>>;
+        using Single = std::integral_constant<bool, Row::size() == 1>;
+
+        Lead keys[searchGroup];
+        Lead probes[searchGroup];
+        bool before[searchGroup];
+        bool tied[searchGroup];
+        for (std::size_t g = 0; g < count; ++g) {
+            keys[g] = get<0>(queries[first + g]);
+            result[g] = 0;
+        }
+        std::size_t length = size;
+        while (length > 1) {
+            const std::size_t half = length / 2;
+            for (std::size_t g = 0; g < count; ++g) {
+                probes[g] = get<0>(rows[result[g] + half]);
+            }
+            bool anyTied = false;
+            for (std::size_t g = 0; g < count; ++g) {
+                before[g] = probes[g] < keys[g];
+                tied[g] = probes[g] == keys[g];
+                anyTied |= tied[g];
+            }
+            if (anyTied) {
+                for (std::size_t g = 0; g < count; ++g) {
+                    if (tied[g]) {
+                        before[g] = lowerTail(rows[result[g] + half], queries[first + g], Single());
+                    }
+                }
+            }
+            length -= half;
+            for (std::size_t g = 0; g < count; ++g) {
+                result[g] += before[g] ? half : 0;
+                __builtin_prefetch(rows + result[g] + length / 2);
+            }
+        }
+        if (size > 0) {
+            for (std::size_t g = 0; g < count; ++g) {
+                result[g] += lower(rows[result[g]], queries[first + g]);
+            }
+        }
+    }
+}
+
+// Writes, for every query in order, the index std::lower_bound(rows, query, Tuple_Traits::lower)
+// would return, e.g. lowerBoundBatch(table, keys, positions.begin()). The rows must be sorted,
+// contiguous (data() and size()) and have an arithmetic leading column; the queries need size()
+// and operator[]. Searches run interleaved in groups, a single lookup gains nothing over
+// std::lower_bound.
+template<typename Rows, typename Queries, typename OutputIt>
+OutputIt lowerBoundBatch(const Rows& sortedRows, const Queries& queries, OutputIt out) {
+    using Row = std::decay_t<decltype(*sortedRows.data())>;
+    static_assert(std::is_arithmetic<Tuple_Traits::tuple_element_t<0, Row>>::value,
+                  "lowerBoundBatch: the leading column is not arithmetic");
+    const std::size_t size = sortedRows.size();
+    const std::size_t count = queries.size();
+    std::size_t result[Tuple_Traits::searchGroup];
+    for (std::size_t first = 0; first < count; first += Tuple_Traits::searchGroup) {
+        const std::size_t group = std::min(Tuple_Traits::searchGroup, count - first);
+        Tuple_Traits::lowerBoundGroup(sortedRows.data(), size, queries, first, group, result);
+        out = std::copy(result, result + group, out);
+    }
+    return out;
+}
+
+#endif //TUPLE_TUPLE_SEARCH_H
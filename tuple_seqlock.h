@@ -0,0 +1,140 @@
+#ifndef TUPLE_TUPLE_SEQLOCK_H
+#define TUPLE_TUPLE_SEQLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "tuple.h"
+
+namespace Tuple_Traits {
+    constexpr std::size_t seqlockWordCount(std::size_t bytes) {
+        return (bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+    }
+
+    inline void seqlockPause() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+}
+
+// A row many threads read without locks while one thread at a time writes it, for rows too wide
+// for AtomicTuple such as configuration snapshots or statistics. The writer makes the sequence
+// number odd, stores the row and makes it even again; a reader copies the row between two loads
+// of the sequence number and retries when they differ or are odd. The row is kept in relaxed
+// atomic 8-byte words so that a copy racing with a write is a retry and not undefined behavior.
+// Writers must be serialized by the caller; readers never block them.
+template<typename... T>
+class SeqlockTuple {
+public:
+    using value_type = Tuple<T...>;
+
+private:
+    static_assert(std::is_trivially_copyable<value_type>::value, "SeqlockTuple: elements must be trivially copyable");
+    constexpr static std::size_t wordCount = Tuple_Traits::seqlockWordCount(sizeof(value_type));
+
+public:
+    SeqlockTuple() noexcept {
+        storeWords(value_type());
+    }
+
+    explicit SeqlockTuple(const value_type& value) noexcept {
+        storeWords(value);
+    }
+
+    SeqlockTuple(const SeqlockTuple&) = delete;
+    SeqlockTuple& operator=(const SeqlockTuple&) = delete;
+
+    // a consistent copy, spins while a write is in progress
+    value_type read() const noexcept {
+        value_type result;
+        while (!tryRead(result)) {
+            Tuple_Traits::seqlockPause();
+        }
+        return result;
+    }
+
+    // one attempt, false if it overlapped a write
+    bool tryRead(value_type& result) const noexcept {
+        const std::uint64_t before = _sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            return false;
+        }
+        std::uint64_t words[wordCount];
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_sequence.load(std::memory_order_relaxed) != before) {
+            return false;
+        }
+        std::memcpy(static_cast<void*>(&result), words, sizeof(value_type));
+        return true;
+    }
+
+    void write(const value_type& value) noexcept {
+        const std::uint64_t sequence = beginWrite();
+        storeWords(value);
+        endWrite(sequence);
+    }
+
+    // the elements themselves, e.g. write(1, 2.0)
+    template<typename... Args, typename = std::enable_if_t<sizeof...(Args) == sizeof...(T) && (sizeof...(T) > 1)>>
+    void write(Args&&... args) noexcept {
+        const value_type value(std::forward<Args>(args)...);
+        write(value);
+    }
+
+    // rewrites only the words that hold element N
+    template<int N>
+    void update(const Tuple_Traits::tuple_element_t<N, value_type>& value) noexcept {
+        constexpr std::size_t offset = Tuple_Traits::tuple_tail_t<N, value_type>::valueOffset();
+        constexpr std::size_t first = offset / sizeof(std::uint64_t);
+        constexpr std::size_t last = Tuple_Traits::seqlockWordCount(offset + sizeof(value));
+        std::uint64_t words[last - first];
+        for (std::size_t i = first; i < last; ++i) {
+            words[i - first] = _words[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(reinterpret_cast<unsigned char*>(words) + offset - first * sizeof(std::uint64_t), &value, sizeof(value));
+        const std::uint64_t sequence = beginWrite();
+        for (std::size_t i = first; i < last; ++i) {
+            _words[i].store(words[i - first], std::memory_order_relaxed);
+        }
+        endWrite(sequence);
+    }
+
+    // number of completed writes
+    std::uint64_t version() const noexcept {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    std::uint64_t beginWrite() noexcept {
+        const std::uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return sequence;
+    }
+
+    void endWrite(std::uint64_t sequence) noexcept {
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    void storeWords(const value_type& value) noexcept {
+        std::uint64_t words[wordCount] = {};
+        std::memcpy(words, &value, sizeof(value_type));
+        for (std::size_t i = 0; i < wordCount; ++i) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    // the sequence number and the start of the row share a cache line
+    alignas(64) std::atomic<std::uint64_t> _sequence{0};
+    std::atomic<std::uint64_t> _words[wordCount];
+};
+
+#endif //TUPLE_TUPLE_SEQLOCK_H
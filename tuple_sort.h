@@ -0,0 +1,335 @@
+#ifndef TUPLE_TUPLE_SORT_H
+#define TUPLE_TUPLE_SORT_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "tuple.h"
+#include "tuple_codec.h"
+#include "tuple_mapped.h"
+
+namespace Tuple_Traits {
+    constexpr std::size_t sortMinBlockRows = 16;
+    constexpr std::size_t sortMaxBlockRows = 4096;
+
+    // memory a value owns outside the row, counted against the sort budget
+    template<typename T>
+    std::size_t heapBytes(const T&) {
+        return 0;
+    }
+
+    inline std::size_t heapBytes(const std::string& value) {
+        return value.capacity();
+    }
+
+    template<typename Row, std::size_t... I>
+    std::size_t rowBytes(const Row& row, std::index_sequence<I...>) {
+        std::size_t bytes = sizeof(Row);
+        const int counted[] = {0, (bytes += heapBytes(get<I>(row)), 0)...};
+        static_cast<void>(counted);
+        return bytes;
+    }
+
+    // a sorted run in a temp file, decoded one block at a time from a mapping; removes the file
+    template<typename Row>
+    class SortRun {
+    public:
+        explicit SortRun(std::string path) : _path(std::move(path)), _file(_path),
+                                             _decoder(_file.data(), _file.size()) {
+            _ok = _decoder.valid();
+            advance();
+        }
+
+        SortRun(const SortRun&) = delete;
+        SortRun& operator=(const SortRun&) = delete;
+
+        ~SortRun() {
+            std::remove(_path.c_str());
+        }
+
+        bool ok() const {
+            return _ok;
+        }
+
+        bool done() const {
+            return _done;
+        }
+
+        Row& row() {
+            return _row;
+        }
+
+        void advance() {
+            _done = !_ok || !_decoder.next(_row);
+            _read += _done ? 0 : 1;
+            // a block that fails to decode ends the run early
+            _ok = _ok && (!_done || _read == _decoder.size());
+        }
+
+    private:
+        std::string _path;
+        FileMapping _file;
+        TupleDecoder<Row> _decoder;
+        Row _row;
+        std::uint64_t _read = 0;
+        bool _ok = false;
+        bool _done = true;
+    };
+
+    // tournament over k runs: _tree[0] is the current winner, every inner node keeps the loser of
+    // the match played there, so replacing the winner replays only the log2(k) matches on its path
+    template<typename Row, typename Less>
+    class LoserTree {
+    public:
+        LoserTree(std::vector<SortRun<Row>*> runs, Less less) : _runs(std::move(runs)), _less(less),
+                                                                  _tree(std::max<std::size_t>(_runs.size(), 1)) {
+            const std::size_t k = _runs.size();
+            std::vector<std::size_t> winners(2 * k);
+            for (std::size_t i = 0; i < k; ++i) {
+                winners[k + i] = i;
+            }
+            for (std::size_t node = k - 1; node >= 1 && k > 1; --node) {
+                const std::size_t left = winners[2 * node];
+                const std::size_t right = winners[2 * node + 1];
+                const bool leftWins = beats(left, right);
+                winners[node] = leftWins ? left : right;
+                _tree[node] = leftWins ? right : left;
+            }
+            _tree[0] = k > 1 ? winners[1] : 0;
+        }
+
+        SortRun<Row>& winner() {
+            return *_runs[_tree[0]];
+        }
+
+        // call after the winner's run has advanced
+        void replay() {
+            std::size_t current = _tree[0];
+            for (std::size_t node = (_runs.size() + current) / 2; node >= 1; node /= 2) {
+                if (beats(_tree[node], current)) {
+                    std::swap(_tree[node], current);
+                }
+            }
+            _tree[0] = current;
+        }
+
+    private:
+        // exhausted runs lose every match, ties go to the earlier run
+        bool beats(std::size_t first, std::size_t second) {
+            if (_runs[first]->done() || _runs[second]->done()) {
+                return !_runs[first]->done();
+            }
+            if (_less(_runs[second]->row(), _runs[first]->row())) {
+                return false;
+            }
+            return _less(_runs[first]->row(), _runs[second]->row()) || first < second;
+        }
+
+        std::vector<SortRun<Row>*> _runs;
+        Less _less;
+        std::vector<std::size_t> _tree;
+    };
+}
+
+// Sorts more rows than fit in memory. Rows are buffered up to memoryBudget bytes, sorted, and
+// spilled as runs in the TupleEncoder format to temp files in `directory`; finish() merges the runs
+// with a loser tree, at most fanIn at a time, and next() then yields the rows in order. A run that
+// cannot be written is dropped with its rows and ok() turns false, so the output is incomplete.
+template<typename Row, typename Less = std::less<Row>>
+class ExternalSorter {
+public:
+    explicit ExternalSorter(std::size_t memoryBudget, std::string directory = ".", Less less = Less(),
+                            std::size_t fanIn = 64)
+            : _budget(memoryBudget), _directory(std::move(directory)), _less(less), _fanIn(fanIn) {
+        assert(fanIn >= 2);
+        _blockRows = std::min(Tuple_Traits::sortMaxBlockRows,
+                              std::max(Tuple_Traits::sortMinBlockRows, memoryBudget / (fanIn * sizeof(Row))));
+    }
+
+    ExternalSorter(const ExternalSorter&) = delete;
+    ExternalSorter& operator=(const ExternalSorter&) = delete;
+
+    ~ExternalSorter() {
+        for (const std::string& path : _paths) {
+            std::remove(path.c_str());
+        }
+    }
+
+    void push(Row row) {
+        assert(!_finished);
+        _bytes += Tuple_Traits::rowBytes(row, std::make_index_sequence<Row::size()>());
+        _buffer.push_back(std::move(row));
+        if (_bytes >= _budget) {
+            spill();
+        }
+    }
+
+    template<typename InputIt>
+    void push(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
+    // call once after the last push
+    void finish() {
+        assert(!_finished);
+        _finished = true;
+        if (_paths.empty()) {
+            std::sort(_buffer.begin(), _buffer.end(), _less);
+            return;
+        }
+        spill();
+        std::vector<Row>().swap(_buffer);
+        while (_ok && _paths.size() > _fanIn) {
+            std::vector<std::unique_ptr<Tuple_Traits::SortRun<Row>>> runs = openRuns(_fanIn);
+            Tuple_Traits::LoserTree<Row, Less> tree(pointers(runs), _less);
+            writeRun([&](TupleEncoder<Row>& encoder) {
+                for (auto* run = &tree.winner(); !run->done(); run = &tree.winner()) {
+                    encoder.append(run->row());
+                    run->advance();
+                    tree.replay();
+                }
+            });
+            _ok = _ok && allRead(runs);
+        }
+        _runs = openRuns(_paths.size());
+        _tree.reset(new Tuple_Traits::LoserTree<Row, Less>(pointers(_runs), _less));
+    }
+
+    // the next row in sorted order, false once all rows are out or a run could not be read back
+    bool next(Row& row) {
+        assert(_finished);
+        if (!_tree) {
+            if (_next == _buffer.size()) {
+                return false;
+            }
+            row = std::move(_buffer[_next++]);
+            return true;
+        }
+        Tuple_Traits::SortRun<Row>& run = _tree->winner();
+        if (run.done()) {
+            _ok = _ok && allRead(_runs);
+            return false;
+        }
+        row = std::move(run.row());
+        run.advance();
+        _tree->replay();
+        return true;
+    }
+
+    // runs written so far, merge passes included
+    std::size_t runCount() const {
+        return _runCount;
+    }
+
+    // false after a temp file could not be written or read back; the rows of that run are lost
+    bool ok() const {
+        return _ok;
+    }
+
+private:
+    template<typename Produce>
+    void writeRun(Produce produce) {
+        std::string path = _directory + "/tuple_sort_XXXXXX";
+        const int fd = ::mkstemp(&path[0]);
+        if (fd < 0) {
+            _ok = false;
+            return;
+        }
+        ::close(fd);
+        _paths.push_back(path);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        {
+            TupleEncoder<Row> encoder(out, _blockRows);
+            produce(encoder);
+        }
+        out.flush();
+        _ok = _ok && static_cast<bool>(out);
+        ++_runCount;
+    }
+
+    // sorts the buffer into a new run and empties it, also when the run could not be written
+    void spill() {
+        std::sort(_buffer.begin(), _buffer.end(), _less);
+        writeRun([&](TupleEncoder<Row>& encoder) {
+            for (const Row& row : _buffer) {
+                encoder.append(row);
+            }
+        });
+        _buffer.clear();
+        _bytes = 0;
+    }
+
+    // the oldest `count` runs; their files are removed once the runs are destroyed
+    std::vector<std::unique_ptr<Tuple_Traits::SortRun<Row>>> openRuns(std::size_t count) {
+        std::vector<std::unique_ptr<Tuple_Traits::SortRun<Row>>> runs;
+        for (std::size_t i = 0; i < count; ++i) {
+            runs.emplace_back(new Tuple_Traits::SortRun<Row>(_paths.front()));
+            _ok = _ok && runs.back()->ok();
+            _paths.pop_front();
+        }
+        return runs;
+    }
+
+    static std::vector<Tuple_Traits::SortRun<Row>*> pointers(
+            const std::vector<std::unique_ptr<Tuple_Traits::SortRun<Row>>>& runs) {
+        std::vector<Tuple_Traits::SortRun<Row>*> result;
+        for (const auto& run : runs) {
+            result.push_back(run.get());
+        }
+        return result;
+    }
+
+    static bool allRead(const std::vector<std::unique_ptr<Tuple_Traits::SortRun<Row>>>& runs) {
+        return std::all_of(runs.begin(), runs.end(), [](const std::unique_ptr<Tuple_Traits::SortRun<Row>>& run) {
+            return run->ok();
+        });
+    }
+
+    std::size_t _budget;
+    std::string _directory;
+    Less _less;
+    std::size_t _fanIn;
+    std::size_t _blockRows;
+    std::vector<Row> _buffer;
+    std::size_t _bytes = 0;
+    std::size_t _next = 0;
+    std::size_t _runCount = 0;
+    bool _finished = false;
+    bool _ok = true;
+    std::deque<std::string> _paths;
+    std::vector<std::unique_ptr<Tuple_Traits::SortRun<Row>>> _runs;
+    std::unique_ptr<Tuple_Traits::LoserTree<Row, Less>> _tree;
+};
+
+// sorts [first, last) into `out` within about memoryBudget bytes of rows; false on a temp file error
+template<typename InputIt, typename OutputIt,
+         typename Less = std::less<typename std::iterator_traits<InputIt>::value_type>>
+bool externalSort(InputIt first, InputIt last, OutputIt out, std::size_t memoryBudget,
+                  const std::string& directory = ".", Less less = Less()) {
+    using Row = typename std::iterator_traits<InputIt>::value_type;
+    ExternalSorter<Row, Less> sorter(memoryBudget, directory, less);
+    sorter.push(first, last);
+    sorter.finish();
+    Row row;
+    while (sorter.next(row)) {
+        *out++ = row;
+    }
+    return sorter.ok();
+}
+
+#endif //TUPLE_TUPLE_SORT_H
@@ -0,0 +1,149 @@
+#ifndef TUPLE_TUPLE_TOPK_H
+#define TUPLE_TUPLE_TOPK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tuple.h"
+#include "tuple_queue.h"
+
+namespace Tuple_Traits {
+    // rows reserved up front; a larger k, or none at all, grows the heap as rows are kept
+    constexpr std::size_t topKReservedRows = 1024;
+}
+
+// The first k rows of a stream under Less, as in ORDER BY ... LIMIT k. The kept rows form a heap
+// whose top is the worst of them, so a candidate costs one comparison against it. When Less is
+// known to order by the leading column first (std::less, std::greater, orderBy<Asc<0>, ...> or
+// orderBy<Desc<0>, ...>), a full heap rejects candidates on that column alone, before the row
+// comparison and before any copy.
+template<typename Row, typename Less = std::less<Row>>
+class TopK {
+public:
+    explicit TopK(std::size_t k, Less less = Less()) : _k(k), _less(less) {
+        _heap.reserve(std::min(k, Tuple_Traits::topKReservedRows));
+    }
+
+    void push(const Row& row) {
+        if (admits(row)) {
+            insert(row);
+        }
+    }
+
+    void push(Row&& row) {
+        if (admits(row)) {
+            insert(std::move(row));
+        }
+    }
+
+    template<typename InputIt>
+    void push(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            push(*first);
+        }
+    }
+
+    // adds the rows another TopK kept, e.g. one per thread
+    void merge(TopK&& other) {
+        for (Row& row : other._heap) {
+            push(std::move(row));
+        }
+        other._heap.clear();
+    }
+
+    std::size_t size() const {
+        return _heap.size();
+    }
+
+    std::size_t k() const {
+        return _k;
+    }
+
+    // the kept rows in order, best first; the TopK is left empty
+    std::vector<Row> take() {
+        std::sort_heap(_heap.begin(), _heap.end(), _less);
+        std::vector<Row> result;
+        result.swap(_heap);
+        return result;
+    }
+
+private:
+    constexpr static int direction = Tuple_Traits::key_direction<Row, Less>::value;
+
+    bool admits(const Row& row) const {
+        if (_heap.size() < _k) {
+            return true;
+        }
+        return _k > 0 && leadingMayBeat(row, std::integral_constant<int, direction>()) && _less(row, _heap.front());
+    }
+
+    // false when the leading column alone puts the row behind the worst kept one
+    bool leadingMayBeat(const Row& row, std::integral_constant<int, 1>) const {
+        return !(get<0>(_heap.front()) < get<0>(row));
+    }
+
+    bool leadingMayBeat(const Row& row, std::integral_constant<int, -1>) const {
+        return !(get<0>(row) < get<0>(_heap.front()));
+    }
+
+    bool leadingMayBeat(const Row&, std::integral_constant<int, 0>) const {
+        return true;
+    }
+
+    template<typename R>
+    void insert(R&& row) {
+        if (_heap.size() == _k) {
+            std::pop_heap(_heap.begin(), _heap.end(), _less);
+            _heap.back() = std::forward<R>(row);
+        } else {
+            _heap.push_back(std::forward<R>(row));
+        }
+        std::push_heap(_heap.begin(), _heap.end(), _less);
+    }
+
+    std::size_t _k;
+    Less _less;
+    std::vector<Row> _heap;
+};
+
+// the first k rows of [first, last) under less, best first
+template<typename InputIt, typename Less = std::less<typename std::iterator_traits<InputIt>::value_type>>
+std::vector<typename std::iterator_traits<InputIt>::value_type> topK(InputIt first, InputIt last, std::size_t k,
+                                                                    Less less = Less()) {
+    TopK<typename std::iterator_traits<InputIt>::value_type, Less> top(k, less);
+    top.push(first, last);
+    return top.take();
+}
+
+// topK over a random-access range split across `threads` threads, whose results are merged
+template<typename RandomIt, typename Less = std::less<typename std::iterator_traits<RandomIt>::value_type>>
+std::vector<typename std::iterator_traits<RandomIt>::value_type> topKParallel(RandomIt first, RandomIt last,
+                                                                            std::size_t k, Less less = Less(),
+                                                                            unsigned threads = std::thread::hardware_concurrency()) {
+    using Top = TopK<typename std::iterator_traits<RandomIt>::value_type, Less>;
+    const std::size_t count = static_cast<std::size_t>(last - first);
+    threads = std::max(1u, threads);
+    std::vector<Top> parts(threads, Top(k, less));
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        const RandomIt begin = first + static_cast<std::ptrdiff_t>(count * t / threads);
+        const RandomIt end = first + static_cast<std::ptrdiff_t>(count * (t + 1) / threads);
+        workers.emplace_back([&parts, t, begin, end] {
+            parts[t].push(begin, end);
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        parts[0].merge(std::move(parts[t]));
+    }
+    return parts[0].take();
+}
+
+#endif //TUPLE_TUPLE_TOPK_H
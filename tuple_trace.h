@@ -0,0 +1,176 @@
+#ifndef TUPLE_TUPLE_TRACE_H
+#define TUPLE_TUPLE_TRACE_H
+
+// Counters behind -DTUPLE_TRACE. Every Tuple type gets its own row; a tuple copies its
+// tail sub-tuples as base subobjects, so Tuple<long> also counts copies of Tuple<int, long>.
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace Tuple_Trace {
+    enum Event {
+        Construct,
+        Copy,
+        Move,
+        CopyAssign,
+        MoveAssign,
+        Compare,
+        ValueCopy,
+        EventCount
+    };
+
+    inline const char* eventName(Event event) {
+        static const char* names[EventCount] = {"construct", "copy", "move", "copy_assign", "move_assign", "compare", "cget"};
+        return names[event];
+    }
+
+    struct Counters {
+        std::string type;
+        unsigned long long events[EventCount];
+
+        unsigned long long operator[](Event event) const {
+            return events[event];
+        }
+    };
+
+    inline std::string demangle(const char* name) {
+#if defined(__GNUG__)
+        int status = 0;
+        std::unique_ptr<char, void (*)(void*)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status),
+                                                         std::free);
+        if (status == 0) {
+            return demangled.get();
+        }
+#endif
+        return name;
+    }
+
+    namespace Details {
+        struct Entry {
+            std::string type;
+            std::atomic<unsigned long long> events[EventCount];
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Entry>> entries;
+        };
+
+        // leaked on purpose so that a dump registered with atexit never sees it destroyed
+        inline Registry& registry() {
+            static Registry* registry = new Registry;
+            return *registry;
+        }
+
+        inline Entry& registerType(const std::type_info& type) {
+            std::unique_ptr<Entry> entry(new Entry);
+            entry->type = demangle(type.name());
+            for (auto& event : entry->events) {
+                event.store(0, std::memory_order_relaxed);
+            }
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lock(r.mutex);
+            r.entries.push_back(std::move(entry));
+            return *r.entries.back();
+        }
+
+        template<typename T>
+        Entry& entry() {
+            static Entry& entry = registerType(typeid(T));
+            return entry;
+        }
+    }
+
+    template<typename T>
+    void record(Event event) {
+        Details::entry<T>().events[event].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    Counters counters() {
+        const Details::Entry& entry = Details::entry<T>();
+        Counters result{entry.type, {}};
+        for (int i = 0; i < EventCount; ++i) {
+            result.events[i] = entry.events[i].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    inline std::vector<Counters> snapshot() {
+        Details::Registry& r = Details::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        std::vector<Counters> result;
+        for (const auto& entry : r.entries) {
+            Counters counters{entry->type, {}};
+            for (int i = 0; i < EventCount; ++i) {
+                counters.events[i] = entry->events[i].load(std::memory_order_relaxed);
+            }
+            result.push_back(counters);
+        }
+        return result;
+    }
+
+    inline void reset() {
+        Details::Registry& r = Details::registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const auto& entry : r.entries) {
+            for (auto& event : entry->events) {
+                event.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    inline void dump(std::ostream& out) {
+        for (const Counters& counters : snapshot()) {
+            out << counters.type << ':';
+            for (int i = 0; i < EventCount; ++i) {
+                out << ' ' << eventName(static_cast<Event>(i)) << '=' << counters.events[i];
+            }
+            out << '\n';
+        }
+    }
+
+    inline void dumpAtExit() {
+        std::atexit([] {
+            dump(std::cerr);
+        });
+    }
+
+    // empty base of every Tuple in trace mode, its special members see the tuple's ones
+    template<typename T>
+    struct Hook {
+        Hook() noexcept {
+            record<T>(Construct);
+        }
+
+        Hook(const Hook&) noexcept {
+            record<T>(Copy);
+        }
+
+        Hook(Hook&&) noexcept {
+            record<T>(Move);
+        }
+
+        Hook& operator=(const Hook&) noexcept {
+            record<T>(CopyAssign);
+            return *this;
+        }
+
+        Hook& operator=(Hook&&) noexcept {
+            record<T>(MoveAssign);
+            return *this;
+        }
+    };
+}
+
+#endif //TUPLE_TUPLE_TRACE_H
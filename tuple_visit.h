@@ -0,0 +1,78 @@
+#ifndef TUPLE_TUPLE_VISIT_H
+#define TUPLE_TUPLE_VISIT_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "tuple.h"
+
+namespace Tuple_Traits {
+    template<std::size_t I, typename T, typename F>
+    using visit_result_t = decltype(std::declval<F>()(get<I>(std::declval<T>())));
+
+    template<typename T, typename F, typename Indices>
+    struct visit_result;
+
+    // the type all element calls convert to; void when every call returns void
+    template<typename T, typename F, std::size_t... I>
+    struct visit_result<T, F, std::index_sequence<I...>> {
+        using type = std::common_type_t<visit_result_t<I, T, F>...>;
+    };
+
+    template<typename Result, std::size_t I, typename T, typename F>
+    Result visitElement(T&& tuple, F& f) {
+        return static_cast<Result>(f(get<I>(std::forward<T>(tuple))));
+    }
+
+    template<typename Result, typename T, typename F, std::size_t... I>
+    Result visitTable(T&& tuple, std::size_t index, F& f, std::index_sequence<I...>) {
+        using Entry = Result (*)(T&&, F&);
+        // one function per element, the call is a single indirect jump whatever the width
+        static constexpr Entry table[] = {&visitElement<Result, I, T, F>...};
+        return table[index](std::forward<T>(tuple), f);
+    }
+
+    // a negative index is refused before the conversion, which could wrap it back into range
+    template<typename Index>
+    std::size_t columnIndex(Index index) {
+        if (std::is_signed<Index>::value && index < Index()) {
+            throw std::out_of_range("visitColumns: negative column index");
+        }
+        return static_cast<std::size_t>(index);
+    }
+}
+
+// f(get<index>(tuple)) for an index known only at run time, through a table of one function per
+// element. Every call's result must convert to their common type, so f is usually generic and
+// returns void or one type for all elements. Throws std::out_of_range for an index past the end,
+// like std::vector::at, in every build.
+template<typename T, typename F, typename = std::enable_if_t<Tuple_Traits::is_tuple<std::decay_t<T>>::value>>
+decltype(auto) visitAt(T&& tuple, std::size_t index, F&& f) {
+    using Indices = std::make_index_sequence<std::decay_t<T>::size()>;
+    using Result = typename Tuple_Traits::visit_result<T, F&, Indices>::type;
+    if (index >= std::decay_t<T>::size()) {
+        throw std::out_of_range("visitAt: column index out of range");
+    }
+    return Tuple_Traits::visitTable<Result>(std::forward<T>(tuple), index, f, Indices());
+}
+
+// f(get<i>(tuple)) for every i of `indices` in order, a projection picked at run time; throws
+// std::out_of_range at the first index that is negative or past the end
+template<typename T, typename Indices, typename F, typename = std::enable_if_t<Tuple_Traits::is_tuple<std::decay_t<T>>::value>>
+void visitColumns(T&& tuple, const Indices& indices, F&& f) {
+    for (const auto index : indices) {
+        visitAt(tuple, Tuple_Traits::columnIndex(index), f);
+    }
+}
+
+template<typename T, typename F, typename = std::enable_if_t<Tuple_Traits::is_tuple<std::decay_t<T>>::value>>
+void visitColumns(T&& tuple, std::initializer_list<std::size_t> indices, F&& f) {
+    for (const std::size_t index : indices) {
+        visitAt(tuple, index, f);
+    }
+}
+
+#endif //TUPLE_TUPLE_VISIT_H
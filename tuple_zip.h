@@ -0,0 +1,173 @@
+#ifndef TUPLE_TUPLE_ZIP_H
+#define TUPLE_TUPLE_ZIP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "tuple.h"
+
+// Random-access iterator over parallel ranges. Dereferencing yields a proxy row
+// Tuple<T1&, T2&, ...> by value: assigning to it or swapping two of them writes through to the
+// ranges, so std::sort on a zip sorts the arrays in place. value_type is Tuple<T1, T2, ...>, which
+// the algorithms use for the element they hold aside. All iterators advance together, the first
+// one decides equality and order.
+template<typename... It>
+class ZipIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Tuple<typename std::iterator_traits<It>::value_type...>;
+    using reference = Tuple<typename std::iterator_traits<It>::reference...>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+
+    ZipIterator() = default;
+
+    explicit ZipIterator(It... iterators) : _iterators(iterators...) {
+    }
+
+    reference operator*() const {
+        return dereference(std::index_sequence_for<It...>());
+    }
+
+    reference operator[](difference_type n) const {
+        return *(*this + n);
+    }
+
+    ZipIterator& operator+=(difference_type n) {
+        advance(n, std::index_sequence_for<It...>());
+        return *this;
+    }
+
+    ZipIterator& operator-=(difference_type n) {
+        return *this += -n;
+    }
+
+    ZipIterator& operator++() {
+        return *this += 1;
+    }
+
+    ZipIterator& operator--() {
+        return *this += -1;
+    }
+
+    ZipIterator operator++(int) {
+        ZipIterator result = *this;
+        ++*this;
+        return result;
+    }
+
+    ZipIterator operator--(int) {
+        ZipIterator result = *this;
+        --*this;
+        return result;
+    }
+
+    friend ZipIterator operator+(ZipIterator iterator, difference_type n) {
+        return iterator += n;
+    }
+
+    friend ZipIterator operator+(difference_type n, ZipIterator iterator) {
+        return iterator += n;
+    }
+
+    friend ZipIterator operator-(ZipIterator iterator, difference_type n) {
+        return iterator -= n;
+    }
+
+    friend difference_type operator-(const ZipIterator& first, const ZipIterator& second) {
+        return get<0>(first._iterators) - get<0>(second._iterators);
+    }
+
+    friend bool operator==(const ZipIterator& first, const ZipIterator& second) {
+        return get<0>(first._iterators) == get<0>(second._iterators);
+    }
+
+    friend bool operator!=(const ZipIterator& first, const ZipIterator& second) {
+        return !(first == second);
+    }
+
+    friend bool operator<(const ZipIterator& first, const ZipIterator& second) {
+        return get<0>(first._iterators) < get<0>(second._iterators);
+    }
+
+    friend bool operator>(const ZipIterator& first, const ZipIterator& second) {
+        return second < first;
+    }
+
+    friend bool operator<=(const ZipIterator& first, const ZipIterator& second) {
+        return !(second < first);
+    }
+
+    friend bool operator>=(const ZipIterator& first, const ZipIterator& second) {
+        return !(first < second);
+    }
+
+private:
+    template<std::size_t... I>
+    reference dereference(std::index_sequence<I...>) const {
+        return reference(*get<I>(_iterators)...);
+    }
+
+    template<std::size_t... I>
+    void advance(difference_type n, std::index_sequence<I...>) {
+        const int advanced[] = {0, (get<I>(_iterators) += n, 0)...};
+        static_cast<void>(advanced);
+    }
+
+    Tuple<It...> _iterators;
+};
+
+template<typename... It>
+class ZipRange {
+public:
+    using iterator = ZipIterator<It...>;
+
+    ZipRange(iterator first, iterator last) : _begin(first), _end(last) {
+    }
+
+    iterator begin() const {
+        return _begin;
+    }
+
+    iterator end() const {
+        return _end;
+    }
+
+    std::size_t size() const {
+        return static_cast<std::size_t>(_end - _begin);
+    }
+
+    typename iterator::reference operator[](std::size_t i) const {
+        return _begin[static_cast<typename iterator::difference_type>(i)];
+    }
+
+private:
+    iterator _begin;
+    iterator _end;
+};
+
+namespace Tuple_Traits {
+    template<typename Range>
+    using range_iterator_t = decltype(std::begin(std::declval<Range&>()));
+
+    template<typename Range>
+    std::ptrdiff_t rangeSize(Range& range) {
+        return std::distance(std::begin(range), std::end(range));
+    }
+}
+
+// zip(ids, timestamps, payloads): rows of the parallel ranges, as long as the shortest of them
+template<typename... Range>
+ZipRange<Tuple_Traits::range_iterator_t<Range>...> zip(Range&... ranges) {
+    static_assert(sizeof...(Range) > 0, "zip: no ranges");
+    const std::ptrdiff_t sizes[] = {Tuple_Traits::rangeSize(ranges)...};
+    const std::ptrdiff_t size = *std::min_element(std::begin(sizes), std::end(sizes));
+    using Iterator = ZipIterator<Tuple_Traits::range_iterator_t<Range>...>;
+    const Iterator first(std::begin(ranges)...);
+    return ZipRange<Tuple_Traits::range_iterator_t<Range>...>(first, first + size);
+}
+
+#endif //TUPLE_TUPLE_ZIP_H
@@ -0,0 +1,235 @@
+#ifndef TUPLE_TYPE_LIST_H
+#define TUPLE_TYPE_LIST_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Type-list helpers with constant or logarithmic instantiation depth, so that long tuples
+// do not run into -ftemplate-depth: indexing goes through __type_pack_element where the
+// compiler has it, otherwise through a single deduction that skips the leading types.
+
+#if defined(__has_builtin)
+#if __has_builtin(__type_pack_element)
+#define TUPLE_HAS_TYPE_PACK_ELEMENT
+#endif
+#endif
+
+namespace Tuple_Traits {
+    template<typename... T>
+    struct type_list {
+        constexpr static std::size_t size() {
+            return sizeof...(T);
+        }
+    };
+
+    // the first N types are matched against void pointers, so one deduction reaches any position
+
+    template<typename T>
+    struct type_tag {
+        using type = T;
+    };
+
+    template<std::size_t I>
+    struct skipped_arg {
+        using type = const volatile void*;
+    };
+
+    template<typename Sequence>
+    struct drop_impl;
+
+    template<std::size_t... I>
+    struct drop_impl<std::index_sequence<I...>> {
+        template<typename... T>
+        static type_list<typename T::type...> select(typename skipped_arg<I>::type..., T*...);
+
+        template<typename T>
+        static T selectFront(typename skipped_arg<I>::type..., T*, ...);
+    };
+
+    // type_at
+
+#ifdef TUPLE_HAS_TYPE_PACK_ELEMENT
+    template<std::size_t N, typename... T>
+    struct type_at_pack {
+        using type = __type_pack_element<N, T...>;
+    };
+#else
+    template<std::size_t N, typename... T>
+    struct type_at_pack {
+        using type = typename decltype(drop_impl<std::make_index_sequence<N>>::selectFront(
+                static_cast<type_tag<T>*>(nullptr)...))::type;
+    };
+#endif
+
+    template<std::size_t N, typename List>
+    struct type_at;
+
+    template<std::size_t N, typename... T>
+    struct type_at<N, type_list<T...>> : type_at_pack<N, T...> {
+        static_assert(N < sizeof...(T), "type_at: index out of range");
+    };
+
+    template<std::size_t N, typename List>
+    using type_at_t = typename type_at<N, List>::type;
+
+    // index_of, first position of T or size() when absent
+
+    template<typename T, typename... U>
+    constexpr std::size_t indexOf() {
+        const bool matches[] = {std::is_same<T, U>::value..., false};
+        std::size_t i = 0;
+        while (i < sizeof...(U) && !matches[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+    template<typename T, typename List>
+    struct index_of;
+
+    template<typename T, typename... U>
+    struct index_of<T, type_list<U...>> : std::integral_constant<std::size_t, indexOf<T, U...>()> {};
+
+    // concat, adjacent lists are joined pairwise so the depth is log2 of the list count
+
+    template<typename... Lists>
+    struct concat;
+
+    template<>
+    struct concat<> {
+        using type = type_list<>;
+    };
+
+    template<typename... T>
+    struct concat<type_list<T...>> {
+        using type = type_list<T...>;
+    };
+
+    template<typename... T, typename... U>
+    struct concat<type_list<T...>, type_list<U...>> {
+        using type = type_list<T..., U...>;
+    };
+
+    template<typename Lists, typename Pairs>
+    struct concat_pairs;
+
+    template<typename... Lists, std::size_t... I>
+    struct concat_pairs<type_list<Lists...>, std::index_sequence<I...>> {
+        using type = typename concat<typename concat<type_at_t<2 * I, type_list<Lists...>>,
+                type_at_t<2 * I + 1, type_list<Lists...>>>::type...>::type;
+    };
+
+    template<typename First, typename Second, typename Third, typename... Other>
+    struct concat<First, Second, Third, Other...> {
+        // an odd tail is padded with an empty list
+        using lists = std::conditional_t<(3 + sizeof...(Other)) % 2 == 0,
+                type_list<First, Second, Third, Other...>,
+                type_list<First, Second, Third, Other..., type_list<>>>;
+        using type = typename concat_pairs<lists, std::make_index_sequence<(4 + sizeof...(Other)) / 2>>::type;
+    };
+
+    template<typename... Lists>
+    using concat_t = typename concat<Lists...>::type;
+
+    // drop, all but the first N types
+
+    template<std::size_t N, typename List>
+    struct drop;
+
+    template<std::size_t N, typename... T>
+    struct drop<N, type_list<T...>> {
+        static_assert(N <= sizeof...(T), "drop: count out of range");
+        using type = decltype(drop_impl<std::make_index_sequence<N>>::select(static_cast<type_tag<T>*>(nullptr)...));
+    };
+
+    template<std::size_t N, typename List>
+    using drop_t = typename drop<N, List>::type;
+
+    // slice, Count types starting at Begin
+
+    template<typename List, typename Sequence>
+    struct take_impl;
+
+    template<typename... T, std::size_t... I>
+    struct take_impl<type_list<T...>, std::index_sequence<I...>> {
+        using type = type_list<typename type_at_pack<I, T...>::type...>;
+    };
+
+    template<std::size_t Begin, std::size_t Count, typename List>
+    struct slice : take_impl<drop_t<Begin, List>, std::make_index_sequence<Count>> {
+        static_assert(Begin + Count <= List::size(), "slice: range out of bounds");
+    };
+
+    template<std::size_t Begin, std::size_t Count, typename List>
+    using slice_t = typename slice<Begin, Count, List>::type;
+
+    // filter, keeps the types with Predicate<T>::value; the kept positions are computed up front
+    // so every survivor is a single type_at
+
+    template<typename... Keep>
+    constexpr std::size_t keptIndex(std::size_t k) {
+        const bool keep[] = {Keep::value..., false};
+        std::size_t i = 0;
+        for (; i < sizeof...(Keep); ++i) {
+            if (keep[i] && k-- == 0) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    template<typename... Keep>
+    constexpr std::size_t keptCount() {
+        const bool keep[] = {Keep::value..., false};
+        std::size_t count = 0;
+        for (bool kept : keep) {
+            count += kept;
+        }
+        return count;
+    }
+
+    template<template<typename> class Predicate, typename List, typename Sequence>
+    struct filter_impl;
+
+    template<template<typename> class Predicate, typename... T, std::size_t... K>
+    struct filter_impl<Predicate, type_list<T...>, std::index_sequence<K...>> {
+        using type = type_list<typename type_at_pack<keptIndex<Predicate<T>...>(K), T...>::type...>;
+    };
+
+    template<template<typename> class Predicate, typename List>
+    struct filter;
+
+    template<template<typename> class Predicate, typename... T>
+    struct filter<Predicate, type_list<T...>>
+            : filter_impl<Predicate, type_list<T...>, std::make_index_sequence<keptCount<Predicate<T>...>()>> {};
+
+    template<template<typename> class Predicate, typename List>
+    using filter_t = typename filter<Predicate, List>::type;
+
+    // conversions between packs of other templates and type_list
+
+    template<typename T>
+    struct to_type_list;
+
+    template<template<typename...> class Pack, typename... T>
+    struct to_type_list<Pack<T...>> {
+        using type = type_list<T...>;
+    };
+
+    template<typename T>
+    using to_type_list_t = typename to_type_list<T>::type;
+
+    template<template<typename...> class Pack, typename List>
+    struct rebind;
+
+    template<template<typename...> class Pack, typename... T>
+    struct rebind<Pack, type_list<T...>> {
+        using type = Pack<T...>;
+    };
+
+    template<template<typename...> class Pack, typename List>
+    using rebind_t = typename rebind<Pack, List>::type;
+}
+
+#endif //TUPLE_TYPE_LIST_H
@@ -0,0 +1,79 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "tuple_visit.h"
+
+// Runtime column access on 8, 64 and 128 column rows: visitAt's jump table against a recursive
+// chain of index comparisons, the shape of a hand-written `if (i == 0) ... else if (i == 1)`,
+// not part of the default build:
+//   cmake --build . --target visit_bench && ./visit_bench
+
+namespace {
+    template<std::size_t I>
+    using column_t = std::conditional_t<I % 2 == 0, std::int64_t, double>;
+
+    template<std::size_t... I>
+    Tuple<column_t<I>...> makeRow(std::index_sequence<I...>) {
+        return Tuple<column_t<I>...>(static_cast<column_t<I>>(I)...);
+    }
+
+    template<std::size_t I, typename Row, typename F>
+    std::enable_if_t<(I == Row::size())> visitChain(const Row&, std::size_t, F&) {
+    }
+
+    template<std::size_t I, typename Row, typename F>
+    std::enable_if_t<(I < Row::size())> visitChain(const Row& row, std::size_t index, F& f) {
+        if (index == I) {
+            f(get<I>(row));
+        } else {
+            visitChain<I + 1>(row, index, f);
+        }
+    }
+
+    constexpr std::size_t visits = 20000000;
+
+    // random indices defeat the branch predictor, a projection repeats a short index list per row
+    template<std::size_t Columns>
+    void bench(const char* pattern, std::size_t distinct) {
+        const auto row = makeRow(std::make_index_sequence<Columns>());
+        std::mt19937 random(1);
+        std::vector<std::size_t> indices(distinct);
+        for (std::size_t& index : indices) {
+            index = random() % Columns;
+        }
+        double sum = 0;
+        const auto add = [&sum](auto value) { sum += static_cast<double>(value); };
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < visits; ++i) {
+            visitAt(row, indices[i % indices.size()], add);
+        }
+        const std::chrono::duration<double, std::nano> table = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < visits; ++i) {
+            visitChain<0>(row, indices[i % indices.size()], add);
+        }
+        const std::chrono::duration<double, std::nano> chain = std::chrono::steady_clock::now() - start;
+
+        std::cout << Columns << " columns, " << pattern << ", ns/visit: visitAt " << table.count() / visits
+                  << ", comparison chain " << chain.count() / visits << " (" << sum << ")\n";
+    }
+}
+
+int main() {
+    for (const std::size_t distinct : {std::size_t(4096), std::size_t(6)}) {
+        const char* pattern = distinct == 6 ? "projection of 6" : "random";
+        bench<8>(pattern, distinct);
+        bench<16>(pattern, distinct);
+        bench<32>(pattern, distinct);
+        bench<64>(pattern, distinct);
+        bench<128>(pattern, distinct);
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "tuple_zip.h"
+
+// Sorting three parallel arrays by (key, id): std::sort over zip() in place against copying the
+// rows into a vector<Tuple>, sorting that and scattering it back, not part of the default build:
+//   cmake --build . --target zip_bench && ./zip_bench
+
+namespace {
+    constexpr std::size_t rowCount = 2000000;
+
+    struct Columns {
+        std::vector<std::uint64_t> keys;
+        std::vector<std::uint32_t> ids;
+        std::vector<double> payloads;
+    };
+
+    Columns makeColumns() {
+        std::mt19937_64 random(4);
+        Columns columns;
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            columns.keys.push_back(random() % 100000);
+            columns.ids.push_back(static_cast<std::uint32_t>(i));
+            columns.payloads.push_back(static_cast<double>(random() % 1000) * 0.5);
+        }
+        return columns;
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main() {
+    const Columns input = makeColumns();
+
+    Columns zipped = input;
+    auto start = std::chrono::steady_clock::now();
+    auto rows = zip(zipped.keys, zipped.ids, zipped.payloads);
+    std::sort(rows.begin(), rows.end());
+    const double zipMs = elapsedMs(start);
+
+    Columns scattered = input;
+    start = std::chrono::steady_clock::now();
+    {
+        std::vector<Tuple<std::uint64_t, std::uint32_t, double>> copies;
+        copies.reserve(rowCount);
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            copies.emplace_back(scattered.keys[i], scattered.ids[i], scattered.payloads[i]);
+        }
+        std::sort(copies.begin(), copies.end());
+        for (std::size_t i = 0; i < rowCount; ++i) {
+            scattered.keys[i] = get<0>(copies[i]);
+            scattered.ids[i] = get<1>(copies[i]);
+            scattered.payloads[i] = get<2>(copies[i]);
+        }
+    }
+    const double copyMs = elapsedMs(start);
+
+    const bool same = zipped.keys == scattered.keys && zipped.ids == scattered.ids && zipped.payloads == scattered.payloads;
+    std::cout << rowCount << " rows, zip sort in place " << zipMs << " ms, copy-sort-scatter " << copyMs
+              << " ms (extra memory " << rowCount * sizeof(Tuple<std::uint64_t, std::uint32_t, double>) / (1 << 20)
+              << " MiB)" << (same ? "" : ", RESULTS DIFFER") << '\n';
+    return 0;
+}